@@ -33,11 +33,17 @@ SOFTWARE.
 #include <time.h>
 #include <ctype.h>
 #include <stdlib.h>
+#include <limits.h>
 #ifdef _WIN32
 #include <windows.h>  // for Windows
 #elif __linux__
 #include <dirent.h>  // for Linux
 #include <regex.h>
+#include <pthread.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>  // SSE2 intrinsics (always available on x64)
+#define USE_SSE2
 #endif
 //#include "stdafx.h"
 
@@ -50,6 +56,16 @@ SOFTWARE.
 extern "C" {
 #endif
 
+#ifdef _WIN32
+#define THREAD_LOCAL  __declspec(thread)
+#define ATOMIC_FETCH_INCREMENT(p)  (InterlockedIncrement(p) - 1)
+typedef HANDLE ThreadHandle;
+#else
+#define THREAD_LOCAL  __thread
+#define ATOMIC_FETCH_INCREMENT(p)  __sync_fetch_and_add(p, 1)
+typedef pthread_t ThreadHandle;
+#endif
+
 #define MAX_FILE_NAME_SIZE  256
 #define MAX_FILE_NAME_LEN  (MAX_FILE_NAME_SIZE - 1)
 
@@ -86,8 +102,21 @@ extern "C" {
 #define MY_BUFFER_SIZE  65536
 #define MAX_MY_BUFFERS  64
 
+#define MAX_VALIDATION_THREADS  64
+#define VALIDATION_TASK_LINES  16384  // csv lines of one column validated by one task
+#define CONVERSION_BLOCK_LINES  1024  // csv lines converted for all mapped columns before the next block (option -batch)
+
+#define READ_BUFFER_PADDING  16  // zero bytes behind content of csv read buffer (for vectorized scans)
+
 #define MAX_DIGITS  64
 
+#define DATE_COMPONENTS  6  // day, month, year, hour, minute, second
+#define MAX_DATE_DELIMITERS  16
+
+#define MIN_HASHED_ENUMERATION_ITEMS  9  // smaller enumerations are searched one by one
+#define MAX_CHARACTER_RANGES  4  // character sets with more ranges are checked character by character
+#define MAX_HASH_DISPLACEMENTS  65536  // tries per bucket to build the perfect hash of an enumeration
+
 //#define MAX_FORMAT_SIZE  1024
 //#define MAX_FORMAT_LEN  (MAX_FORMAT_SIZE - 1)
 
@@ -143,6 +172,8 @@ typedef char FileName[MAX_FILE_NAME_SIZE];
 
 typedef enum { CSV2XML, XML2CSV } ConversionDirection;
 
+typedef enum { AUTO_ENCODING, UTF8_ENCODING, LATIN1_ENCODING, CP1252_ENCODING } InputEncoding;
+
 typedef struct {
   char szName[MAX_ATTR_NAME_SIZE];
   char szValue[MAX_ATTR_VALUE_SIZE];
@@ -160,6 +191,8 @@ typedef struct SimpleCondition {
   cpchar szOperator;
   cpchar szRightPart;
   pchar szCurrentValue;
+  int nLeftColumnIndex;  // csv conditions: column index of left part
+  int nRightColumnIndex;  // csv conditions: column index of right part (if not quoted)
 } SimpleCondition;
 
 typedef struct ComplexCondition;
@@ -182,6 +215,83 @@ typedef Condition const *CPCondition;
 typedef SimpleCondition *PSimpleCondition;
 typedef ComplexCondition *PComplexCondition;
 
+typedef struct {
+  cpchar pszValue;  // item of enumeration within the format string (not zero terminated)
+  int nLen;
+} EnumerationItem;
+
+typedef struct {
+  bool bCompiled;  // false = boolean format not compiled (MapBoolFormat is used)
+  EnumerationItem aSource[2];  // first and second string of the source format
+  EnumerationItem aDest[2];  // destination string for the first and second source string
+} BooleanLookup;
+
+#define MAX_TRANSFORM_STEPS 8
+
+typedef struct {
+  char cOperation;  // 'T' = trim, 'L' = trim left, 'R' = trim right, 'U' = upper, 'D' = lower, 'S' = substring, 'P' = pad left, 'Q' = pad right, 'X' = replace
+  int nArg1;  // substring: start position (1 = first character), left/right: length, pad: width
+  int nArg2;  // substring: length (-1 = till end of value)
+  cpchar pszFrom;  // replace: searched string, pad: fill character (within the transform string, not zero terminated)
+  int nFromLen;
+  cpchar pszTo;  // replace: replacement string
+  int nToLen;
+} TransformStep;
+
+typedef struct {
+  int nSteps;  // 0 = value is not transformed
+  TransformStep aStep[MAX_TRANSFORM_STEPS];
+} ValueTransform;
+
+typedef unsigned char CharacterSet[32];  // bit per character code
+
+typedef struct {
+  int nRanges;  // 0 = too many ranges (check character set only)
+  unsigned char acFrom[MAX_CHARACTER_RANGES];  // first character of range
+  unsigned char acWidth[MAX_CHARACTER_RANGES];  // last minus first character of range
+} CharacterRanges;
+
+typedef struct {
+  char cKind;  // '\0' = not compiled (CheckRegex), 'N' = no check, 'E' = enumeration, 'P' = characters per position, 'C' = valid characters
+  int nItems;  // enumeration: number of items, pattern: number of positions
+  EnumerationItem *aItem;  // enumeration items in the order of the list
+  int nHashBuckets;  // perfect hash of enumeration items (0 = items are searched one by one)
+  unsigned int *anDisplacement;  // displacement per hash bucket
+  int nHashSlots;
+  int *anSlotItem;  // index of enumeration item per hash slot (-1 = free slot)
+  CharacterSet *aPositionChars;  // allowed characters per position
+  CharacterSet ValidChars;
+  CharacterRanges ValidRanges;  // same characters as ValidChars for block checks
+} FormatMatcher;
+
+typedef enum { NUMBER_VALID, NUMBER_INT_TOO_LONG, NUMBER_FRACTION_TOO_LONG, NUMBER_INVALID_CHARS } NumberScanResult;
+
+typedef struct {
+  bool bNegative;
+  bool bDecimalPoint;  // decimal point found in scanned string
+  int nIntDigits;  // significant digits before the decimal point (without leading zeros)
+  int nDigits;  // all significant digits (without trailing zeros after the decimal point, 0 = zero)
+  char acDigits[2 * MAX_DIGITS];
+} DecimalNumber;
+
+typedef struct {
+  long long nValue;  // integer, mantissa of number or days since 01.01.1970 (same as decoded csv values)
+  int nExtra;  // number of fraction digits (number) or seconds since midnight (date)
+  bool bBinary;  // nValue and nExtra are exact (numbers with up to 18 significant digits)
+  DecimalNumber Number;  // exact integer or number
+} RangeLimit;
+
+typedef enum { DATE_DAY, DATE_MONTH, DATE_YEAR, DATE_HOUR, DATE_MINUTE, DATE_SECOND } DateComponent;
+
+typedef struct {
+  cpchar pszFormat;  // NULL = not compiled
+  int nLen;  // length of date values
+  int anOffset[DATE_COMPONENTS];  // position of component in date value (-1 = not part of the format)
+  int anWidth[DATE_COMPONENTS];
+  int nDelimiters;  // -1 = too many delimiters (checked with format string)
+  int anDelimiterPos[MAX_DATE_DELIMITERS];
+} DateCodec;
+
 typedef struct {
   char cOperation;  // Fix, Var, Map, Line/Loop
   cpchar szContent;  // Constant, Variable, Column Name or XPath
@@ -193,14 +303,21 @@ typedef struct {
   char cType;  // Text, Integer, Number, Date, Boolean
   int nMinLen;
   int nMaxLen;
+  int nPosition;  // start position of fixed width field (1 = first character, 0 = delimited csv field)
+  int nWidth;  // number of characters of fixed width field
   cpchar szMinValue;
   cpchar szMaxValue;
   int nMinValue;
   int nMaxValue;
   double fMinValue;
   double fMaxValue;
+  RangeLimit *pMinLimit;  // szMinValue decoded once (NULL = no limit)
+  RangeLimit *pMaxLimit;
   cpchar szFormat;
+  FormatMatcher Format;  // compiled version of szFormat
+  DateCodec DateFormat;  // compiled version of szFormat (date fields only)
   cpchar szTransform;
+  ValueTransform Transform;  // compiled version of szTransform
   cpchar szDefault;
   pchar szCondition;
   Condition Condition;
@@ -211,6 +328,19 @@ typedef struct {
 typedef FieldDefinition const *CPFieldDefinition;
 
 typedef struct {
+  int *anOffset;  // offset of xml value per csv data line (-1 = converted when used)
+  pchar pValues;  // zero terminated xml values of the column
+  int nSize;
+  int nUsed;
+} ConvertedColumn;
+
+struct FieldMapping;
+
+// conversion of one value for the combination of csv and xml type (selected once per field mapping)
+typedef int (*CsvToXmlConverter)(struct FieldMapping const *pFieldMapping, cpchar pCsvValue, pchar pXmlValue, int nMaxLen, bool bCheckLimits);
+typedef int (*XmlToCsvConverter)(struct FieldMapping const *pFieldMapping, cpchar pXmlValue, pchar pCsvValue, int nMaxLen);
+
+typedef struct FieldMapping {
   FieldDefinition csv;
   FieldDefinition xml;
   int nCsvFileIndex;
@@ -220,11 +350,113 @@ typedef struct {
   int nSourceMapIndex;
   int nLoopIndex;
   int nRefUniqueLoopIndex;
+  unsigned char *anCellError;  // validation result per csv data line (0 = valid, NULL = not validated)
+  CsvToXmlConverter pConvertCsvToXml;  // NULL = different types (value is not converted)
+  XmlToCsvConverter pConvertXmlToCsv;
+  ConvertedColumn Converted;  // xml values converted column by column (option -batch)
+  bool bConstantXmlValue;  // xml value is one of a few constant strings (text node content taken from pConstantXmlValues)
+  BooleanLookup CsvToXmlBoolean;  // compiled boolean mapping for each direction
+  BooleanLookup XmlToCsvBoolean;
 } FieldMapping;
 
 typedef FieldMapping *PFieldMapping;
 typedef FieldMapping const *CPFieldMapping;
 
+typedef struct {
+  int nExactEntry;  // first entry of the names ending at this node (-1 = none)
+  int nPrefixEntry;  // first entry of the name patterns "prefix*" ending at this node (-1 = none)
+  int nMinValue;  // minimum value of all names within the subtree of this node (-1 = none)
+} NameIndexNode;
+
+typedef struct {
+  int nValue;
+  int nNextEntry;  // next entry with the same name (-1 = none)
+} NameIndexEntry;
+
+typedef struct {
+  int nNodes;
+  int nMaxNodes;
+  NameIndexNode *aNode;  // case insensitive character trie, node 0 is the root
+  int nEdgeSlots;  // size of the hash table for child nodes (power of 2)
+  int *anEdgeKey;  // parent node * 256 + character (-1 = empty slot)
+  int *anEdgeChild;
+  int nEntries;
+  int nMaxEntries;
+  NameIndexEntry *aEntry;
+} NameIndex;
+
+typedef enum { TYPED_VALID, TYPED_EMPTY, TYPED_SYNTAX_ERROR, TYPED_OVERFLOW, TYPED_CALENDAR_ERROR } TypedValueError;
+
+typedef struct {
+  long long nValue;  // integer value, mantissa of number or days since 01.01.1970 (date)
+  int nExtra;  // number of fraction digits (number) or seconds since midnight (date)
+  int nErrorCode;  // TypedValueError
+} TypedValue;
+
+typedef struct {
+  char cType;  // Integer, Number, Date (0 = column not decoded)
+  cpchar szFormat;  // csv date format
+  DateCodec const *pDateCodec;  // compiled csv date format
+  int nValidValues;
+  TypedValue *aValue;  // one value per csv data line
+  unsigned char *abValid;  // bitmap of valid values (one bit per csv data line)
+  CPFieldDefinition pRangeDefinition;  // limits checked for the whole column (NULL = none)
+  unsigned char *abInRange;  // bitmap of valid values within the limits of pRangeDefinition
+} TypedColumn;
+
+typedef struct {
+  int nOffset;  // position of the first character (0 = start of line)
+  int nWidth;
+} FixedWidthField;
+
+typedef struct {
+  cpchar pszValue;  // first occurrence of the value in a csv read buffer
+  unsigned int nHash;
+} DictionaryEntry;
+
+typedef struct {
+  int nSlots;  // size of hash table (power of 2)
+  int *anSlot;  // entry index (-1 = empty slot)
+  int nEntries;
+  DictionaryEntry *aEntry;  // entry index = id of the value
+} StringDictionary;
+
+typedef struct {
+  int *anValueId;  // dictionary id per csv data line (NULL = column not interned)
+  int *anFirstLine;  // first csv data line per dictionary id (-1 = value not in this column)
+  int nValueIds;
+} InternedColumn;
+
+typedef struct {
+  int nMapIndex;
+  int nFirstLine;
+  int nLastLine;  // first line behind the task
+  int nErrors;
+  pchar pValues;  // xml values of the valid csv values (moved to the field mapping after the validation)
+  int nSize;
+  int nUsed;
+} ValidationTask;
+
+typedef struct {
+  int nCsvFileIndex;
+  int nLine;
+  int nColumnIndex;
+  int nTextOffset;  // column name, xpath, value and error message in the text buffer (-1 = error not written)
+} CellError;
+
+typedef struct {
+  int nCellErrors;
+  int nMaxCellErrors;
+  CellError *aCellError;
+  int nTextSize;
+  int nMaxTextSize;
+  char *pText;
+  int nSlots;
+  int *anSlot;  // hash table of csv cells with errors (index of cell error, -1 = free slot)
+  int nSkippedErrors;  // errors not written because of the limit per column
+  int anColumnErrors[MAX_LINKED_CSV_FILES][MAX_CSV_COLUMNS];
+} ErrorCollector;
+
 typedef struct {
   FileName szFileName;
   int nDataBufferSize;
@@ -234,7 +466,6 @@ typedef struct {
   int nDataFieldsBufferSize;
   pchar *aDataFields;
   bool abColumnQuoted[MAX_CSV_COLUMNS];
-  bool abColumnError[MAX_CSV_COLUMNS];
   int nRealDataLines;
   int nLinkedColumnIndex;
   int nLinkedMainColumnIndex;
@@ -244,6 +475,13 @@ typedef struct {
   int nMatchingFirstLine;
   int nMatchingLastLine;
   int nCurrentCsvLine;
+  int nFilteredDataLines;
+  NameIndex HeaderIndex;  // index of the column names of the header line (value: column index)
+  TypedColumn *aTypedColumn;  // binary values of integer, number and date columns (optional, one entry per column)
+  InternedColumn *aInternedColumn;  // dictionary ids of loop and key columns (one entry per column)
+  int nFixedWidthFields;  // number of columns of fixed width file (0 = delimited csv file)
+  FixedWidthField aFixedWidthField[MAX_CSV_COLUMNS];
+  char *pFieldBuffer;  // content of fixed width fields (without padding)
 } LinkedCsvFile;
 
 // global constants
@@ -271,6 +509,8 @@ const char szOperationUnknown[] = "?";
 // global variables
 
 ConversionDirection convDir;
+FormatMatcher DefaultBooleanMatcher;  // compiled version of szDefaultBooleanFormat
+InputEncoding inputEncoding = AUTO_ENCODING;  // encoding of csv input files (detected automatically by default)
 int nFieldMappings = 0;
 FieldMapping aFieldMapping[MAX_FIELD_MAPPINGS];
 int nFieldMappingBufferSize = 0;
@@ -283,8 +523,8 @@ int nMyBuffers = 0;
 pchar apMyBuffer[MAX_MY_BUFFERS];
 char cColumnDelimiter = ';';  // default column delimiter is semicolon
 char cDecimalPoint = '.';  // default decimal point is point
+char cThousandsSeparator = '\0';  // thousands separator of csv numbers (ignored when reading, written by xml to csv conversion)
 char szIgnoreChars[8] = " \t";  // default space-like characters to be ignored during parsing a csv line
-char szTempConvertNumber[MAX_NUMBER_VALUE_SIZE];
 int nLoops = 0;
 int anLoopIndex[MAX_LOOPS];
 int anLoopSize[MAX_LOOPS];
@@ -309,22 +549,49 @@ char szLineBuffer[MAX_LINE_SIZE];
 char szFieldValueBuffer[MAX_LINE_SIZE];
 char szUniqueDocumentID[MAX_UNIQUE_DOCUMENT_ID_SIZE];
 char szCounterPath[MAX_FILE_NAME_SIZE] = "";
-char szLastError[MAX_ERROR_MESSAGE_SIZE];
-char szLastFieldMappingError[MAX_ERROR_MESSAGE_SIZE];
+THREAD_LOCAL char szLastError[MAX_ERROR_MESSAGE_SIZE];  // thread local for the validation threads
+THREAD_LOCAL char szLastFieldMappingError[MAX_ERROR_MESSAGE_SIZE];
 char szErrorFileName[MAX_FILE_NAME_SIZE];
-FILE *pErrorFile = NULL;
 int nErrors = 0;
+int nMaxColumnErrors = 0;  // maximum number of errors written to the error file per csv column (0 = no limit)
+ErrorCollector CellErrors;  // errors collected during the conversion (written to the error file at the end)
 char szMappingErrorFileName[MAX_FILE_NAME_SIZE];
 FILE *pMappingErrorFile = NULL;
 int nMappingErrors = 0;
 pchar pszLastErrorPos = NULL;
+NameIndex MappingColumnIndex;  // index of csv column names referenced by the mapping definition
+StringDictionary CsvValueDictionary;  // distinct values of interned csv columns (all csv files)
+int nMinNonEmptyColumns = 3;  // minimum number of non-empty columns of csv data lines
+char szKeyColumnName[MAX_FILE_NAME_SIZE] = "";  // column that must not be empty in csv data lines (optional)
+char szCommentPrefix[MAX_FILE_NAME_SIZE] = "";  // csv lines starting with this prefix are skipped (optional)
+bool bTypedDecode = false;  // decode integer, number and date columns once after reading the csv file
+bool bBatchConvert = false;  // convert mapped csv columns in blocks of lines before generating the xml document
+bool bValidateOnly = false;  // check csv values and write error file without generating the xml document
+int nValidationThreads = 0;  // threads for checking the csv values before generating the xml document (0 = no separate check)
+ValidationTask *aValidationTask = NULL;
+int nValidationTasks = 0;
+#ifdef _WIN32
+volatile LONG nNextValidationTask = 0;
+#else
+volatile int nNextValidationTask = 0;
+#endif
+char szRowFilter[MAX_CONDITION_SIZE] = "";  // condition for data lines of the main csv file to be converted
+Condition RowFilter;
 xmlDocPtr pXmlDoc = NULL;
+xmlDictPtr pConstantXmlValues = NULL;  // values of FIX mappings and xml enumerations (interned once, shared by the xml document)
 bool bTrace = false; //true;
 char cPathSeparator = '\\';  // change to '/' for linux
 
 //--------------------------------------------------------------------------------------------------------
 
 bool ConvertNumber(cpchar szValue, char cType, int *pnValue, double *pfValue);
+void AddCharacterRange(unsigned char *pCharSet, char cFrom, char cTo);
+int GetCharacterSetSpan(cpchar pszString, const unsigned char *pCharSet, CharacterRanges const *pRanges);
+int GetDecimalSpan(cpchar pszString, char cDecimalPoint);
+int GetDaysOfMonth(int nYear, int nMonth);
+void ResolveCsvConditions();
+void ResolveCsvConditionColumns(CPCondition pCondition, int nCsvFileIndex, bool bMappedColumns);
+bool EvaluateCsvRowCondition(cpchar const *aRowField, int nRowFields, CPCondition pCondition);
 
 //--------------------------------------------------------------------------------------------------------
 
@@ -676,48 +943,177 @@ int LogMappingError(int nMapIndex, cpchar szOperation, cpchar szColumnName, cpch
 
 //--------------------------------------------------------------------------------------------------------
 
+void FreeErrorCollector(ErrorCollector *pCollector)
+{
+  free(pCollector->aCellError);
+  free(pCollector->pText);
+  free(pCollector->anSlot);
+  memset(pCollector, 0, sizeof(ErrorCollector));
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int GetCellErrorSlot(ErrorCollector *pCollector, int nCsvFileIndex, int nLine, int nColumnIndex)
+{
+  // get hash slot of csv cell (slot of existing cell error or free slot)
+  int i, nSlot;
+  unsigned int nHash = ((unsigned int)nLine * 2654435761u) ^ ((unsigned int)nColumnIndex * 40503u) ^ (unsigned int)nCsvFileIndex;
+  CellError *pCellError;
+
+  nSlot = (int)((nHash ^ (nHash >> 15)) & (pCollector->nSlots - 1));
+  while ((i = pCollector->anSlot[nSlot]) >= 0) {
+    pCellError = pCollector->aCellError + i;
+    if (pCellError->nLine == nLine && pCellError->nColumnIndex == nColumnIndex && pCellError->nCsvFileIndex == nCsvFileIndex)
+      break;
+    nSlot = (nSlot + 1) & (pCollector->nSlots - 1);
+  }
+
+  return nSlot;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int AddErrorText(ErrorCollector *pCollector, cpchar szText)
+{
+  // append zero terminated text to the text buffer of the error collector (-1 = not enough memory)
+  int nLen = (int)strlen(szText) + 1;
+  int nTextOffset = pCollector->nTextSize;
+
+  if (pCollector->nTextSize + nLen > pCollector->nMaxTextSize) {
+    int nMaxTextSize = pCollector->nMaxTextSize ? 2 * pCollector->nMaxTextSize : 65536;
+    while (nMaxTextSize < pCollector->nTextSize + nLen)
+      nMaxTextSize *= 2;
+    char *pText = (char*)realloc(pCollector->pText, nMaxTextSize);
+    if (!pText)
+      return -1;
+    pCollector->pText = pText;
+    pCollector->nMaxTextSize = nMaxTextSize;
+  }
+
+  memcpy(pCollector->pText + pCollector->nTextSize, szText, nLen);
+  pCollector->nTextSize += nLen;
+
+  return nTextOffset;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
 int LogXmlError(int nCsvFileIndex, int nLine, int nColumnIndex, cpchar szColumnName, cpchar szXPath, cpchar szValue, cpchar szError)
 {
-  int nReturnCode = 0;
-  //errno_t error_code;
-  LinkedCsvFile *pLinkedCsvFile;
+  // add error to the error collector (the error file is written by WriteErrorFile)
+  int i, nSlot = -1;
+  ErrorCollector *pCollector = &CellErrors;
+  CellError *pCellError;
 
   if (nCsvFileIndex < 0 || nCsvFileIndex >= nLinkedCsvFiles)
     return 0;  // invalid csv file index
 
-  pLinkedCsvFile = aLinkedCsvFile + nCsvFileIndex;
-
-  if (nColumnIndex < 0 || nColumnIndex >= pLinkedCsvFile->nColumns)
+  if (nColumnIndex < 0 || nColumnIndex >= aLinkedCsvFile[nCsvFileIndex].nColumns)
     return 0;  // invalid column index
 
-  if (pLinkedCsvFile->abColumnError[nColumnIndex])
-    return 0;  // report only first error for each column
+  if (convDir == CSV2XML) {
+    // report only first error for each csv cell
+    if (2 * pCollector->nCellErrors >= pCollector->nSlots) {
+      // enlarge hash table (load factor below 0.5)
+      int nSlots = pCollector->nSlots ? 2 * pCollector->nSlots : 1024;
+      int *anSlot = (int*)malloc(nSlots * sizeof(int));
+      if (!anSlot)
+        return -1;
+      free(pCollector->anSlot);
+      pCollector->anSlot = anSlot;
+      pCollector->nSlots = nSlots;
+      memset(anSlot, -1, nSlots * sizeof(int));
+      for (i = 0, pCellError = pCollector->aCellError; i < pCollector->nCellErrors; i++, pCellError++)
+        anSlot[GetCellErrorSlot(pCollector, pCellError->nCsvFileIndex, pCellError->nLine, pCellError->nColumnIndex)] = i;
+    }
+
+    nSlot = GetCellErrorSlot(pCollector, nCsvFileIndex, nLine, nColumnIndex);
+    if (pCollector->anSlot[nSlot] >= 0)
+      return 0;  // error of csv cell already reported
+  }
+
+  if (pCollector->nCellErrors >= pCollector->nMaxCellErrors) {
+    int nMaxCellErrors = pCollector->nMaxCellErrors ? 2 * pCollector->nMaxCellErrors : 1024;
+    CellError *aCellError = (CellError*)realloc(pCollector->aCellError, nMaxCellErrors * sizeof(CellError));
+    if (!aCellError)
+      return -1;
+    pCollector->aCellError = aCellError;
+    pCollector->nMaxCellErrors = nMaxCellErrors;
+  }
 
   nErrors++;
 
-  if (convDir == CSV2XML)
-    pLinkedCsvFile->abColumnError[nColumnIndex] = true;
+  pCellError = pCollector->aCellError + pCollector->nCellErrors;
+  pCellError->nCsvFileIndex = nCsvFileIndex;
+  pCellError->nLine = nLine;
+  pCellError->nColumnIndex = nColumnIndex;
+  pCellError->nTextOffset = -1;
+
+  if (nMaxColumnErrors <= 0 || ++pCollector->anColumnErrors[nCsvFileIndex][nColumnIndex] <= nMaxColumnErrors) {
+    pCellError->nTextOffset = AddErrorText(pCollector, szColumnName);
+    if (pCellError->nTextOffset < 0 || AddErrorText(pCollector, szXPath) < 0 || AddErrorText(pCollector, szValue) < 0 || AddErrorText(pCollector, szError) < 0)
+      return -1;
+  }
+  else
+    pCollector->nSkippedErrors++;
+
+  if (nSlot >= 0)
+    pCollector->anSlot[nSlot] = pCollector->nCellErrors;
+  pCollector->nCellErrors++;
+
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------------
 
-  if (!pErrorFile) {
+int WriteErrorFile()
+{
+  // write collected errors to the error file (file is only created if errors were detected)
+  int i, nReturnCode = 0;
+  FILE *pErrorFile = NULL;
+  //errno_t error_code;
+  ErrorCollector *pCollector = &CellErrors;
+  CellError *pCellError;
+  cpchar szColumnName, szXPath, szValue, szError;
+
+  if (pCollector->nCellErrors > 0) {
     // open file in write mode
     //error_code = fopen_s(&pErrorFile, szErrorFileName, "w");
     pErrorFile = fopen(szErrorFileName, "w");
     if (!pErrorFile) {
       //printf("Cannot open file '%s' (error code %d)\n", szErrorFileName, error_code);
       printf("Cannot open file '%s'\n", szErrorFileName);
+      FreeErrorCollector(pCollector);
       return -2;
     }
 
     // write header of error file
     nReturnCode = fputs("FILE;LINE;COLUMN_NR;COLUMN_NAME;XPATH;VALUE;ERROR\n", pErrorFile);
+
+    for (i = 0, pCellError = pCollector->aCellError; i < pCollector->nCellErrors && nReturnCode >= 0; i++, pCellError++) {
+      if (pCellError->nTextOffset < 0)
+        continue;  // limit of errors per column reached
+
+      szColumnName = pCollector->pText + pCellError->nTextOffset;
+      szXPath = szColumnName + strlen(szColumnName) + 1;
+      szValue = szXPath + strlen(szXPath) + 1;
+      szError = szValue + strlen(szValue) + 1;
+
+      if (*szXPath)
+        nReturnCode = fprintf(pErrorFile, "%d;%d;%d;\"%s\";\"%s\";\"%s\";\"%s\"\n", pCellError->nCsvFileIndex + 1, pCellError->nLine, pCellError->nColumnIndex + 1, szColumnName, szXPath, szValue, szError);
+      else
+        nReturnCode = fprintf(pErrorFile, "%d;%d;%d;\"%s\";;\"%s\";\"%s\"\n", pCellError->nCsvFileIndex + 1, pCellError->nLine, pCellError->nColumnIndex + 1, szColumnName, szValue, szError);
+    }
+
+    fclose(pErrorFile);
+
+    if (pCollector->nSkippedErrors > 0)
+      printf("Errors not written to error file: %d (limit of %d errors per column)\n", pCollector->nSkippedErrors, nMaxColumnErrors);
   }
 
-  if (*szXPath)
-    nReturnCode = fprintf(pErrorFile, "%d;%d;%d;\"%s\";\"%s\";\"%s\";\"%s\"\n", nCsvFileIndex + 1, nLine, nColumnIndex + 1, szColumnName, szXPath, szValue, szError);
-  else
-    nReturnCode = fprintf(pErrorFile, "%d;%d;%d;\"%s\";;\"%s\";\"%s\"\n", nCsvFileIndex + 1, nLine, nColumnIndex + 1, szColumnName, szValue, szError);
+  FreeErrorCollector(pCollector);
 
-  return nReturnCode;
+  return (nReturnCode < 0) ? -2 : 0;
 }
 
 //--------------------------------------------------------------------------------------------------------
@@ -1061,14 +1457,32 @@ xmlNodePtr SetNodeValue(xmlDocPtr pDoc, xmlNodePtr pParentNode, const char * pXP
     //xmlNodePtr pNode = GetCreateNode(pParentNode, pXPath, pszConditionAttributeName, pszConditionAttributeValue);
 
     if (strlen(pFieldMapping->xml.szAttribute) == 0) {
-      if (*pValue)
-        xmlNodeSetContent(pNode, xmlEncodeSpecialChars(pDoc, (const xmlChar *)pValue));
+      if (*pValue && pFieldMapping->bConstantXmlValue && pDoc->dict) {
+        // constant value: text node shares the interned string (no copy per node)
+        xmlNodeSetContent(pNode, NULL);
+        xmlNodePtr pTextNode = xmlNewDocText(pDoc, NULL);
+        if (pTextNode) {
+          pTextNode->content = (xmlChar *)xmlDictLookup(pDoc->dict, (const xmlChar *)pValue, -1);
+          xmlAddChild(pNode, pTextNode);
+        }
+      }
+      else
+      if (*pValue) {
+        // text node with the unchanged value (special characters are escaped when the document is written)
+        // xmlNodeSetContent would resolve entity references, so only values without '&' are set directly
+        if (strchr(pValue, '&') == NULL)
+          xmlNodeSetContent(pNode, (const xmlChar *)pValue);
+        else {
+          xmlNodeSetContent(pNode, NULL);
+          xmlNodeAddContent(pNode, (const xmlChar *)pValue);
+        }
+      }
     }
     else {
       // xmlChar *xmlGetProp (const xmlNode *node, const xmlChar *name)
       // xmlAttrPtr	xmlSetProp(xmlNodePtr node, const xmlChar *name, const xmlChar *value)
-      xmlSetProp(pNode, (const xmlChar *)pFieldMapping->xml.szAttribute, xmlEncodeSpecialChars(pDoc, (const xmlChar *)pValue));
-      //xmlNewProp(pNode, (const xmlChar *)pFieldMapping->xml.szAttribute, xmlEncodeSpecialChars(pDoc, (const xmlChar *)pValue));
+      // (the value is stored unchanged, escaping it here would escape it twice)
+      xmlSetProp(pNode, (const xmlChar *)pFieldMapping->xml.szAttribute, (const xmlChar *)pValue);
     }
   }
 
@@ -1133,6 +1547,7 @@ void CopyIgnoreString(pchar pszDest, cpchar pszSource, cpchar pszIgnoreChars)
 
 bool ValidChars(cpchar pszString, cpchar pszValidChars)
 {
+  // short strings and character lists (compiled formats use GetCharacterSetSpan)
   for (cpchar p = pszString; *p; p++)
     if (!strchr(pszValidChars, *p))
       return false;
@@ -1145,8 +1560,6 @@ bool ValidChars(cpchar pszString, cpchar pszValidChars)
 bool IsValidNumber(cpchar pszString, char cDecimalPoint)
 {
   cpchar pszTest = pszString;
-  char szValidChars[32];
-  bool bResult;
 
   // empty string ?
   if (!*pszTest)
@@ -1156,11 +1569,8 @@ bool IsValidNumber(cpchar pszString, char cDecimalPoint)
   if (strchr("+-", *pszTest))
     pszTest++;
 
-  // check valid characters (digits plus decimal point)
-  sprintf(szValidChars, "%s%c", szDigits, cDecimalPoint);
-  bResult = ValidChars(pszTest, szValidChars);
-
-  return bResult;
+  // check valid characters (digits plus one decimal point)
+  return pszTest[GetDecimalSpan(pszTest, cDecimalPoint)] == '\0';
 }
 
 //--------------------------------------------------------------------------------------------------------
@@ -1240,2061 +1650,5396 @@ bool CheckRegex(cpchar pszString, cpchar pszRegex)
 
 //--------------------------------------------------------------------------------------------------------
 
-bool IsValidText(cpchar pszString, CPFieldMapping pFieldMapping)
+unsigned int GetEnumerationHash(cpchar pValue, int nLen)
 {
-  bool bResult = true;
-
-  if (!*pszString && !pFieldMapping->csv.bMandatory)
-    return true;  // empty string allowed for optional fields
+  // FNV-1a hash of enumeration item (not zero terminated)
+  unsigned int nHash = 2166136261u;
 
-  if (!*pszString && pFieldMapping->csv.bMandatory)
-    return false;  // empty string not allowed for mandatory fields
+  for (int i = 0; i < nLen; i++)
+    nHash = (nHash ^ (unsigned char)pValue[i]) * 16777619u;
 
-  if (pFieldMapping->csv.nMaxLen > 0 && (int)strlen(pszString) > pFieldMapping->csv.nMaxLen)
-    return false;  // string is too long
+  return nHash;
+}
 
-  if (pFieldMapping->csv.nMinLen > 0 && (int)strlen(pszString) < pFieldMapping->csv.nMinLen)
-    return false;  // string is too short
+//--------------------------------------------------------------------------------------------------------
 
-  if (*pFieldMapping->csv.szFormat)
-    bResult = CheckRegex(pszString, pFieldMapping->csv.szFormat);
+int GetEnumerationSlot(unsigned int nHash, unsigned int nDisplacement, int nHashSlots)
+{
+  unsigned int nSlotHash = (nHash ^ (nDisplacement * 0x9E3779B9u)) * 0x85EBCA6Bu;
 
-  return bResult;
+  return (int)((nSlotHash ^ (nSlotHash >> 16)) & (unsigned int)(nHashSlots - 1));
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-int MapIntFormat(cpchar pszSourceValue, cpchar pszSourceFormat, pchar pszDestValue, cpchar pszDestFormat, int nMaxLen)
+bool IsEqualEnumerationItem(EnumerationItem const *pItem, cpchar pValue, int nLen)
 {
-  int nErrorCode = 0;
-  cpchar pSourceValue = pszSourceValue;
-  pchar pDestValue = pszDestValue;
+  return pItem->nLen == nLen && memcmp(pItem->pszValue, pValue, nLen) == 0;
+}
 
-  if ((int)strlen(pszSourceValue) > nMaxLen)
-    return -1;  // destination value buffer is too small
- 
-  if (*pSourceValue == '+')
-    pSourceValue++;  // remove plus sign at the start
+//--------------------------------------------------------------------------------------------------------
+
+int BuildEnumerationHash(FormatMatcher *pMatcher)
+{
+  // build perfect hash of the enumeration items ("hash and displace"): the items of each bucket are moved
+  // together by the first displacement that leads to free slots for all of them (largest buckets first)
+  // only the first occurrence of an item is hashed, so the lowest item index is found like in the list
+  // if no perfect hash is found, the items are searched one by one (return code 0 anyway, -1 = not enough memory)
+  int i, j, k, nBucket, nBucketItems, nMaxBucketItems = 0, nReturnCode = 0;
+  unsigned int *anHash = (unsigned int*)malloc(pMatcher->nItems * sizeof(unsigned int));
+  int *anBucketStart = (int*)calloc(pMatcher->nItems / 4 + 2, sizeof(int));
+  int *anBucketItem = (int*)malloc(pMatcher->nItems * sizeof(int));
+  int *anSlot = (int*)malloc(pMatcher->nItems * sizeof(int));
+  unsigned int nDisplacement;
+  EnumerationItem const *pItem;
+
+  pMatcher->nHashBuckets = pMatcher->nItems / 4 + 1;
+  for (pMatcher->nHashSlots = 16; pMatcher->nHashSlots < 2 * pMatcher->nItems; pMatcher->nHashSlots *= 2);
+  pMatcher->anDisplacement = (unsigned int*)calloc(pMatcher->nHashBuckets, sizeof(unsigned int));
+  pMatcher->anSlotItem = (int*)malloc(pMatcher->nHashSlots * sizeof(int));
+
+  if (!anHash || !anBucketStart || !anBucketItem || !anSlot || !pMatcher->anDisplacement || !pMatcher->anSlotItem)
+    nReturnCode = -1;
+  else {
+    memset(pMatcher->anSlotItem, -1, pMatcher->nHashSlots * sizeof(int));
+
+    // count items per bucket (duplicates are marked with bucket -1)
+    for (i = 0, pItem = pMatcher->aItem; i < pMatcher->nItems; i++, pItem++) {
+      anHash[i] = GetEnumerationHash(pItem->pszValue, pItem->nLen);
+      for (j = 0; j < i && !(anHash[j] == anHash[i] && IsEqualEnumerationItem(pMatcher->aItem + j, pItem->pszValue, pItem->nLen)); j++);
+      anSlot[i] = (j < i) ? -1 : (int)(anHash[i] % pMatcher->nHashBuckets);
+      if (anSlot[i] >= 0)
+        anBucketStart[anSlot[i] + 1]++;
+    }
 
-  CopyIgnoreString(pszDestValue, pSourceValue, " ");
+    // order items by bucket
+    for (nBucket = 0; nBucket < pMatcher->nHashBuckets; nBucket++) {
+      if (anBucketStart[nBucket + 1] > nMaxBucketItems)
+        nMaxBucketItems = anBucketStart[nBucket + 1];
+      anBucketStart[nBucket + 1] += anBucketStart[nBucket];
+    }
+    for (i = 0; i < pMatcher->nItems; i++)
+      if (anSlot[i] >= 0)
+        anBucketItem[anBucketStart[anSlot[i]]++] = i;
+    for (nBucket = pMatcher->nHashBuckets; nBucket > 0; nBucket--)
+      anBucketStart[nBucket] = anBucketStart[nBucket - 1];
+    anBucketStart[0] = 0;
+
+    // place buckets with most items first
+    for (nBucketItems = nMaxBucketItems; nBucketItems > 0 && pMatcher->nHashBuckets > 0; nBucketItems--)
+      for (nBucket = 0; nBucket < pMatcher->nHashBuckets; nBucket++) {
+        if (anBucketStart[nBucket + 1] - anBucketStart[nBucket] != nBucketItems)
+          continue;
+
+        for (nDisplacement = 0; nDisplacement < MAX_HASH_DISPLACEMENTS; nDisplacement++) {
+          for (k = 0; k < nBucketItems; k++) {
+            anSlot[k] = GetEnumerationSlot(anHash[anBucketItem[anBucketStart[nBucket] + k]], nDisplacement, pMatcher->nHashSlots);
+            if (pMatcher->anSlotItem[anSlot[k]] >= 0)
+              break;  // slot already used
+            for (j = 0; j < k && anSlot[j] != anSlot[k]; j++);
+            if (j < k)
+              break;  // same slot for two items of this bucket
+          }
+          if (k == nBucketItems)
+            break;  // free slots found for all items of this bucket
+        }
 
-  if (*pDestValue == '-')
-    pDestValue++;  // skip minus sign at the start
+        if (nDisplacement >= MAX_HASH_DISPLACEMENTS) {
+          // no perfect hash found --> search items one by one
+          pMatcher->nHashBuckets = 0;
+          break;
+        }
 
-  if (strlen(pDestValue) > MAX_DIGITS) {
-    sprintf(szLastFieldMappingError, "Number too long (maximum digits %d)", MAX_DIGITS);
-    return 2;
+        pMatcher->anDisplacement[nBucket] = nDisplacement;
+        for (k = 0; k < nBucketItems; k++)
+          pMatcher->anSlotItem[anSlot[k]] = anBucketItem[anBucketStart[nBucket] + k];
+      }
   }
-  if (!ValidChars(pDestValue, szDigits)) {
-    strcpy(szLastFieldMappingError, "Invalid number (invalid characters found)");
-    return 3;
+
+  if (nReturnCode != 0 || pMatcher->nHashBuckets == 0) {
+    free(pMatcher->anDisplacement);
+    free(pMatcher->anSlotItem);
+    pMatcher->anDisplacement = NULL;
+    pMatcher->anSlotItem = NULL;
+    pMatcher->nHashBuckets = 0;
+    pMatcher->nHashSlots = 0;
   }
 
-  return nErrorCode;
+  free(anHash);
+  free(anBucketStart);
+  free(anBucketItem);
+  free(anSlot);
+
+  return nReturnCode;
 }
+// end of function "BuildEnumerationHash"
 
 //--------------------------------------------------------------------------------------------------------
 
-int CheckMinMaxValues(cpchar pszValue, CPFieldDefinition pFieldDefinition)
+int FindEnumerationItem(FormatMatcher const *pMatcher, cpchar pValue, int nLen)
 {
-  int nErrorCode = 0;
-  int nValue;
-  double fValue;
+  // get index of first matching enumeration item (-1 = not found)
+  int i;
 
-  if (!IsEmptyString(pFieldDefinition->szMinValue) || !IsEmptyString(pFieldDefinition->szMaxValue)) {
-    ConvertNumber(pszValue, pFieldDefinition->cType, &nValue, &fValue);
+  if (pMatcher->nHashBuckets > 0) {
+    unsigned int nHash = GetEnumerationHash(pValue, nLen);
+    i = pMatcher->anSlotItem[GetEnumerationSlot(nHash, pMatcher->anDisplacement[nHash % pMatcher->nHashBuckets], pMatcher->nHashSlots)];
+    return (i >= 0 && IsEqualEnumerationItem(pMatcher->aItem + i, pValue, nLen)) ? i : -1;
+  }
 
-    /*
-    if (pFieldDefinition->cType == 'I') {
-      printf("CheckMinMaxValues '%s' %d", pszValue, nValue);
-      if (!IsEmptyString(pFieldDefinition->szMinValue))
-        printf(" Min=%s/%d", pFieldDefinition->szMinValue, pFieldDefinition->nMinValue);
-      if (!IsEmptyString(pFieldDefinition->szMaxValue))
-        printf(" Max=%s/%d", pFieldDefinition->szMaxValue, pFieldDefinition->nMaxValue);
-      puts("\n");
-    }
-    if (pFieldDefinition->cType == 'N') {
-      printf("CheckMinMaxValues '%s' %lf", pszValue, fValue);
-      if (!IsEmptyString(pFieldDefinition->szMinValue))
-        printf(" Min=%s/%lf", pFieldDefinition->szMinValue, pFieldDefinition->fMinValue);
-      if (!IsEmptyString(pFieldDefinition->szMaxValue))
-        printf(" Max=%s/%lf", pFieldDefinition->szMaxValue, pFieldDefinition->fMaxValue);
-      puts("\n");
-    }
-    */
+  for (i = 0; i < pMatcher->nItems; i++)
+    if (IsEqualEnumerationItem(pMatcher->aItem + i, pValue, nLen))
+      return i;
 
-    if (pFieldDefinition->cType == 'I'/*INTEGER*/) {
-      if (!IsEmptyString(pFieldDefinition->szMinValue) && nValue < pFieldDefinition->nMinValue) {
-        sprintf(szLastFieldMappingError, "Integer value below limit %d", pFieldDefinition->nMinValue);
-        return 4;
-      }
-      if (!IsEmptyString(pFieldDefinition->szMaxValue) && nValue > pFieldDefinition->nMaxValue) {
-        sprintf(szLastFieldMappingError, "Integer value above limit %d", pFieldDefinition->nMaxValue);
-        return 4;
-      }
-    }
+  return -1;
+}
 
-    if (pFieldDefinition->cType == 'N'/*NUMBER*/) {
-      if (!IsEmptyString(pFieldDefinition->szMinValue) && fValue < pFieldDefinition->fMinValue) {
-        sprintf(szLastFieldMappingError, "Number value below limit %lf", pFieldDefinition->fMinValue);
-        return 4;
-      }
-      if (!IsEmptyString(pFieldDefinition->szMaxValue) && fValue > pFieldDefinition->fMaxValue) {
-        sprintf(szLastFieldMappingError, "Number value above limit %lf", pFieldDefinition->fMaxValue);
-        return 4;
-      }
-    }
-  }
+//--------------------------------------------------------------------------------------------------------
 
-  return nErrorCode;
+void AddCharacterRange(unsigned char *pCharSet, char cFrom, char cTo)
+{
+  // same comparison as CheckRegex (plain char)
+  for (int i = 0; i < 256; i++)
+    if ((char)i >= cFrom && (char)i <= cTo)
+      pCharSet[i >> 3] |= (unsigned char)(1 << (i & 7));
 }
-// end of function "CheckMinMaxValues"
 
 //--------------------------------------------------------------------------------------------------------
 
-int MapNumberFormat(cpchar pszSourceValue, char cSourceDecimalPoint, cpchar pszSourceFormat, pchar pszDestValue, char cDestDecimalPoint, cpchar pszDestFormat, int nMaxLen)
+bool IsInCharacterSet(const unsigned char *pCharSet, char c)
 {
-  int nErrorCode = 0;
-  char szIgnoreChars[3];
-  cpchar pSourceValue = pszSourceValue;
-  pchar pDestValue = pszDestValue;
-  char *pPos = NULL;
+  return (pCharSet[(unsigned char)c >> 3] & (1 << ((unsigned char)c & 7))) != 0;
+}
 
-  if ((int)strlen(pszSourceValue) > nMaxLen)
-    return -1;  // destination value buffer is too small
- 
-  if (*pSourceValue == '+')
-    pSourceValue++;  // ignore plus sign at the start
+//--------------------------------------------------------------------------------------------------------
 
-  if (convDir == CSV2XML) {
-    // copy source number to destination buffer without 1000-delimiters
-    strcpy(szIgnoreChars, (cSourceDecimalPoint == '.') ? ", " : ". ");
-    CopyIgnoreString(pszDestValue, pSourceValue, szIgnoreChars);
-  }
-  else
-    strcpy(pszDestValue, pSourceValue);
+void GetCharacterRanges(const unsigned char *pCharSet, CharacterRanges *pRanges)
+{
+  // split character set into ranges of consecutive character codes (string end is never part of a range)
+  int i, nFrom;
 
-  // check number format
-  if (*pDestValue == '-')
-    pDestValue++;  // skip minus sign at the start
+  pRanges->nRanges = 0;
+  for (i = 1; i < 256; i++) {
+    if (!IsInCharacterSet(pCharSet, (char)i))
+      continue;
 
-  pPos = strchr(pszDestValue, cSourceDecimalPoint);
-  if (pPos) {
-    // check integer part of number (before comma/dot)
-    *pPos = '\0';
-    if (strlen(pDestValue) > MAX_DIGITS) {
-      sprintf(szLastFieldMappingError, "Number too long (maximum digits %d before decimal point)", MAX_DIGITS);
-      return 2;
-    }
-    if (!ValidChars(pDestValue, szDigits)) {
-      sprintf(szLastFieldMappingError, "Invalid number (invalid characters found, decimal point is '%c')", cSourceDecimalPoint);
-      return 3;
-    }
-    // change decimal character to destination format
-    *pPos++ = cDestDecimalPoint;
-    // check fraction part of number (behind comma/dot)
-    pDestValue = pPos;
-    if (strlen(pDestValue) > MAX_DIGITS) {
-      sprintf(szLastFieldMappingError, "Number too long (maximum digits %d after decimal point)", MAX_DIGITS);
-      return 2;
-    }
-    if (!ValidChars(pDestValue, szDigits)) {
-      sprintf(szLastFieldMappingError, "Invalid number (invalid characters found, decimal point is '%c')", cSourceDecimalPoint);
-      return 3;
+    if (pRanges->nRanges >= MAX_CHARACTER_RANGES) {
+      pRanges->nRanges = 0;
+      return;
     }
+
+    nFrom = i;
+    while (i < 255 && IsInCharacterSet(pCharSet, (char)(i + 1)))
+      i++;
+    pRanges->acFrom[pRanges->nRanges] = (unsigned char)nFrom;
+    pRanges->acWidth[pRanges->nRanges] = (unsigned char)(i - nFrom);
+    pRanges->nRanges++;
   }
-  else {
-    // check integer number
-    if (strlen(pDestValue) > MAX_DIGITS) {
-      sprintf(szLastFieldMappingError, "Number too long (maximum digits %d)", MAX_DIGITS);
-      return 2;
-    }
-    if (!ValidChars(pDestValue, szDigits)) {
-      sprintf(szLastFieldMappingError, "Invalid number (invalid characters found, decimal point is '%c')", cSourceDecimalPoint);
-      return 3;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int GetCharacterSetSpan(cpchar pszString, const unsigned char *pCharSet, CharacterRanges const *pRanges)
+{
+  // length of the beginning of the string with characters of the set only (the set must not contain '\0')
+  cpchar p = pszString;
+
+#ifdef USE_SSE2
+  if (pRanges && pRanges->nRanges > 0) {
+    // characters up to the next 16 byte boundary one by one, then aligned blocks of 16 characters at once
+    // (an aligned block never crosses the end of a memory page, so it may be read behind the string end)
+    for (; ((size_t)p & 15) != 0; p++)
+      if (!IsInCharacterSet(pCharSet, *p))
+        return (int)(p - pszString);
+
+    for (;; p += 16) {
+      __m128i block = _mm_load_si128((const __m128i*)p);
+      __m128i vInRange = _mm_setzero_si128();
+      for (int i = 0; i < pRanges->nRanges; i++) {
+        // unsigned offset to first character of range is not above width of range
+        __m128i vOffset = _mm_sub_epi8(block, _mm_set1_epi8((char)pRanges->acFrom[i]));
+        vInRange = _mm_or_si128(vInRange, _mm_cmpeq_epi8(_mm_min_epu8(vOffset, _mm_set1_epi8((char)pRanges->acWidth[i])), vOffset));
+      }
+      int nMask = ~_mm_movemask_epi8(vInRange) & 0xFFFF;
+      if (nMask) {
+        while (!(nMask & 1)) {
+          nMask >>= 1;
+          p++;
+        }
+        return (int)(p - pszString);
+      }
     }
   }
+#endif
 
-  return nErrorCode;
+  while (IsInCharacterSet(pCharSet, *p))
+    p++;
+
+  return (int)(p - pszString);
 }
-// end of function "MapNumberFormat"
 
 //--------------------------------------------------------------------------------------------------------
 
-int MapDateFormat(cpchar pszSourceValue, cpchar pszSourceFormat, pchar pszDestValue, cpchar pszDestFormat)
+int GetLowestBit(unsigned int nMask)
 {
-  int nErrorCode = 0;
-  int nDay = 1;
-  int nMonth = 1;
-  int nYear = 2000;
-  int nHour = 0;
-  int nMinute = 0;
-  int nSecond = 0;
-  cpchar pPos = NULL;
-  char szDay[3];
-  char szMonth[3];
-  char szYear[5];
-  char szHour[3];
-  char szMinute[3];
-  char szSecond[3];
-
-  if (strlen(pszSourceValue) != strlen(pszSourceFormat))
-    return 1;
+  // index of lowest bit set (mask must not be 0)
+#ifdef _WIN32
+  unsigned long nIndex;
+  _BitScanForward(&nIndex, nMask);
+  return (int)nIndex;
+#else
+  return __builtin_ctz(nMask);
+#endif
+}
 
-  // parse source date
-  pPos = strstr(pszSourceFormat, "DD");
-  if (pPos) {
-    memcpy(szDay, pszSourceValue + (pPos - pszSourceFormat), 2);
-    szDay[2] = '\0';
-    nDay = atoi(szDay);
-    if (nDay < 1) { nDay = 1; nErrorCode = 2; }
-    if (nDay > 31) { nDay = 31; nErrorCode = 2; }
-  }
+//--------------------------------------------------------------------------------------------------------
 
-  pPos = strstr(pszSourceFormat, "MM");
-  if (pPos) {
-    memcpy(szMonth, pszSourceValue + (pPos - pszSourceFormat), 2);
-    szMonth[2] = '\0';
-    nMonth = atoi(szMonth);
-    if (nMonth < 1) { nMonth = 1; nErrorCode = 2; }
-    if (nMonth > 12) { nMonth = 12; nErrorCode = 2; }
-  }
+int GetDigitSpan(cpchar pszString)
+{
+  static const CharacterSet DigitChars = { 0, 0, 0, 0, 0, 0, 0xFF, 0x03 };  // '0' to '9'
+  static const CharacterRanges DigitRanges = { 1, { '0' }, { 9 } };
 
-  pPos = strstr(pszSourceFormat, "YYYY");
-  if (pPos) {
-    memcpy(szYear, pszSourceValue + (pPos - pszSourceFormat), 4);
-    szYear[4] = '\0';
-    nYear = atoi(szYear);
-    if (nYear < 1900) { nYear = 1900; nErrorCode = 2; }
-    if (nYear > 2150) { nYear = 2150; nErrorCode = 2; }
-  }
-  else {
-    pPos = strstr(pszSourceFormat, "YY");
-    if (pPos) {
-      memcpy(szYear, pszSourceValue + (pPos - pszSourceFormat), 2);
-      szYear[2] = '\0';
-      nYear = 2000 + atoi(szYear);
-    }
-  }
+  return GetCharacterSetSpan(pszString, DigitChars, &DigitRanges);
+}
 
-  pPos = strstr(pszSourceFormat, "hh");
-  if (pPos) {
-    memcpy(szHour, pszSourceValue + (pPos - pszSourceFormat), 2);
-    szHour[2] = '\0';
-    nHour = atoi(szHour);
-    if (nHour < 0) { nHour = 0; nErrorCode = 2; }
-    if (nHour > 23) { nHour = 0; nErrorCode = 2; }
-  }
+//--------------------------------------------------------------------------------------------------------
 
-  pPos = strstr(pszSourceFormat, "mm");
-  if (pPos) {
-    memcpy(szMinute, pszSourceValue + (pPos - pszSourceFormat), 2);
-    szMinute[2] = '\0';
-    nMinute = atoi(szMinute);
-    if (nMinute < 0) { nMinute = 0; nErrorCode = 2; }
-    if (nMinute > 59) { nMinute = 0; nErrorCode = 2; }
-  }
+int GetDecimalSpan(cpchar pszString, char cDecimalPoint)
+{
+  // length of the beginning of the string with digits and one decimal point at most
+  int nLen = GetDigitSpan(pszString);
 
-  pPos = strstr(pszSourceFormat, "ss");
-  if (pPos) {
-    memcpy(szSecond, pszSourceValue + (pPos - pszSourceFormat), 2);
-    szSecond[2] = '\0';
-    nSecond = atoi(szSecond);
-    if (nSecond < 0) { nSecond = 0; nErrorCode = 2; }
-    if (nSecond > 59) { nSecond = 0; nErrorCode = 2; }
-  }
+  if (cDecimalPoint && pszString[nLen] == cDecimalPoint)
+    nLen += 1 + GetDigitSpan(pszString + nLen + 1);
 
-  // check delimiters
-  for (int i = strlen(pszSourceFormat) - 1; i >= 0; i--)
-    if (!strchr("DMYhms", pszSourceFormat[i]) && pszSourceFormat[i] != pszSourceValue[i])
-      nErrorCode = 2;  // Invalid delimiter found
+  return nLen;
+}
 
-  // build result date
-  strcpy(pszDestValue, pszDestFormat);
+//--------------------------------------------------------------------------------------------------------
 
-  pPos = strstr(pszDestFormat, "DD");
-  if (pPos) {
-    sprintf(szDay, "%02d", nDay);
-    memcpy(pszDestValue + (pPos - pszDestFormat), szDay, 2);
+int CompileFormat(FormatMatcher *pMatcher, cpchar pszFormat)
+{
+  // compile format of mapping definition once into a matcher with the same result as CheckRegex
+  // (not compiled if not enough memory or in ambiguous cases, then CheckRegex is used)
+  int nItems = 0;
+  cpchar pPos, pComma;
+  unsigned char *pCharSet;
+
+  memset(pMatcher, 0, sizeof(FormatMatcher));
+
+  if (IsEmptyString(pszFormat)) {
+    pMatcher->cKind = 'N';
+    return 0;
   }
 
-  pPos = strstr(pszDestFormat, "MM");
-  if (pPos) {
-    sprintf(szMonth, "%02d", nMonth);
-    memcpy(pszDestValue + (pPos - pszDestFormat), szMonth, 2);
+  if (*pszFormat == ',') {
+    // enumeration ",AIF,UCITS," (items between two commas)
+    for (pPos = pszFormat + 1; *pPos; pPos++)
+      if (*pPos == ',')
+        nItems++;
+
+    pMatcher->aItem = (EnumerationItem*)malloc((nItems + 1) * sizeof(EnumerationItem));
+    if (!pMatcher->aItem)
+      return -1;
+
+    for (pPos = pszFormat + 1; (pComma = strchr(pPos, ',')) != NULL; pPos = pComma + 1) {
+      pMatcher->aItem[pMatcher->nItems].pszValue = pPos;
+      pMatcher->aItem[pMatcher->nItems].nLen = (int)(pComma - pPos);
+      pMatcher->nItems++;
+    }
+
+    pMatcher->cKind = 'E';
+
+    // perfect hash for larger lists (e.g. currencies or countries)
+    if (pMatcher->nItems >= MIN_HASHED_ENUMERATION_ITEMS && BuildEnumerationHash(pMatcher) != 0) {
+      free(pMatcher->aItem);
+      memset(pMatcher, 0, sizeof(FormatMatcher));
+      return -1;
+    }
   }
+  else
+  if (strstr(pszFormat, ".[") != NULL || strstr(pszFormat, "].") != NULL) {
+    // pattern with dots "..[B-C]." (any character, list of characters/ranges or other character never matching)
+    pMatcher->aPositionChars = (CharacterSet*)malloc(strlen(pszFormat) * sizeof(CharacterSet));
+    if (!pMatcher->aPositionChars)
+      return -1;
+
+    for (pPos = pszFormat; *pPos; pPos++) {
+      pCharSet = pMatcher->aPositionChars[pMatcher->nItems++];
+      memset(pCharSet, (*pPos == '.') ? 0xFF : 0, sizeof(CharacterSet));
+      if (*pPos == '[') {
+        pPos++;  // skip '['
+        while (*pPos && *pPos != ']') {
+          if (pPos[1] == '-' && pPos[2]) {
+            if (pPos[2] == ']') {
+              // closing bracket as end of range: leave this pattern to CheckRegex
+              free(pMatcher->aPositionChars);
+              memset(pMatcher, 0, sizeof(FormatMatcher));
+              return 0;
+            }
+            AddCharacterRange(pCharSet, *pPos, pPos[2]);
+            pPos += 3;
+          }
+          else {
+            AddCharacterRange(pCharSet, *pPos, *pPos);
+            pPos++;
+          }
+        }
+        if (*pPos != ']') {
+          // error in regular expression (closing bracket missing) --> no match at this position
+          memset(pCharSet, 0, sizeof(CharacterSet));
+          break;
+        }
+      }
+    }
 
-  pPos = strstr(pszDestFormat, "YYYY");
-  if (pPos) {
-    sprintf(szYear, "%04d", nYear);
-    memcpy(pszDestValue + (pPos - pszDestFormat), szYear, 4);
+    pMatcher->cKind = 'P';
   }
-  else {
-    pPos = strstr(pszDestFormat, "YY");
-    if (pPos) {
-      sprintf(szYear, "%04d", nYear);
-      memcpy(pszDestValue + (pPos - pszDestFormat), szYear + 2, 2);
+  else
+  if (*pszFormat == '[') {
+    // pattern with allowed characters (length is checked separately)
+    pMatcher->cKind = 'N';
+    if (strncmp(pszFormat, "[0-9]", 5) == 0 || strncmp(pszFormat, "[0-9A-Z]", 8) == 0 || strncmp(pszFormat, "[0-9a-zA-Z]", 11) == 0) {
+      AddCharacterRange(pMatcher->ValidChars, '0', '9');
+      pMatcher->cKind = 'C';
+    }
+    if (strncmp(pszFormat, "[a-z]", 5) == 0 || strncmp(pszFormat, "[a-zA-Z]", 8) == 0 || strncmp(pszFormat, "[0-9a-zA-Z]", 11) == 0) {
+      AddCharacterRange(pMatcher->ValidChars, 'a', 'z');
+      pMatcher->cKind = 'C';
     }
+    if (strncmp(pszFormat, "[A-Z]", 5) == 0 || strncmp(pszFormat, "[0-9A-Z]", 8) == 0 || strncmp(pszFormat, "[a-zA-Z]", 8) == 0 || strncmp(pszFormat, "[0-9a-zA-Z]", 11) == 0) {
+      AddCharacterRange(pMatcher->ValidChars, 'A', 'Z');
+      pMatcher->cKind = 'C';
+    }
+    GetCharacterRanges(pMatcher->ValidChars, &pMatcher->ValidRanges);
   }
+  else
+    pMatcher->cKind = 'N';
 
-  pPos = strstr(pszDestFormat, "hh");
-  if (pPos) {
-    sprintf(szHour, "%02d", nHour);
-    memcpy(pszDestValue + (pPos - pszDestFormat), szHour, 2);
-  }
+  return 0;
+}
+// end of function "CompileFormat"
 
-  pPos = strstr(pszDestFormat, "mm");
-  if (pPos) {
-    sprintf(szMinute, "%02d", nHour);
-    memcpy(pszDestValue + (pPos - pszDestFormat), szMinute, 2);
-  }
+//--------------------------------------------------------------------------------------------------------
 
-  pPos = strstr(pszDestFormat, "ss");
-  if (pPos) {
-    sprintf(szSecond, "%02d", nHour);
-    memcpy(pszDestValue + (pPos - pszDestFormat), szSecond, 2);
+bool MatchFormat(cpchar pszString, FormatMatcher const *pMatcher, cpchar pszFormat)
+{
+  // check string with compiled format (pszFormat is used, if the format was not compiled)
+  int i, nLen;
+
+  switch (pMatcher->cKind) {
+    case 'N':
+      return true;
+
+    case 'E':
+      if (strchr(pszString, ','))
+        return CheckRegex(pszString, pszFormat);  // value spanning several items
+
+      nLen = (int)strlen(pszString);
+      if (nLen > MAX_VALUE_SIZE)
+        return false;
+
+      return FindEnumerationItem(pMatcher, pszString, nLen) >= 0;
+
+    case 'P':
+      for (i = 0; i < pMatcher->nItems && pszString[i]; i++)
+        if (!IsInCharacterSet(pMatcher->aPositionChars[i], pszString[i]))
+          return false;
+      return true;
+
+    case 'C':
+      return pszString[GetCharacterSetSpan(pszString, pMatcher->ValidChars, &pMatcher->ValidRanges)] == '\0';
   }
 
-  return nErrorCode;
+  return CheckRegex(pszString, pszFormat);
 }
-// end of function "MapDateFormat"
 
 //--------------------------------------------------------------------------------------------------------
 
-int MapTextFormat(cpchar pszSourceValue, CPFieldDefinition pSourceFieldDef, pchar pszDestValue, CPFieldDefinition pDestFieldDef, int nMaxLen)
+bool CheckFieldFormat(cpchar pszString, CPFieldDefinition pFieldDefinition)
 {
-  char szShortFormat[MAX_FORMAT_ERROR_SIZE+4];
-  int nLen = (int)strlen(pszSourceValue);
-  int nErrorCode = 0;
-  int nAddLen;
+  return MatchFormat(pszString, &pFieldDefinition->Format, pFieldDefinition->szFormat);
+}
 
-  *szLastFieldMappingError = '\0';
-  *pszDestValue = '\0';
+//--------------------------------------------------------------------------------------------------------
 
-  //if (strcmp(pDestFieldDef->szContent, "CCY") == 0)
-  //  nErrorCode = 0;  // for debugging purposes only!
+bool IsValidText(cpchar pszString, CPFieldMapping pFieldMapping)
+{
+  bool bResult = true;
 
-  if (!*pszSourceValue && !pSourceFieldDef->bMandatory)
-    return 0;  // empty value is allowed for optional fields
+  if (!*pszString && !pFieldMapping->csv.bMandatory)
+    return true;  // empty string allowed for optional fields
 
-  if (nLen > nMaxLen)
-    return -1;  // destination value buffer is too small
+  if (!*pszString && pFieldMapping->csv.bMandatory)
+    return false;  // empty string not allowed for mandatory fields
 
-  if (nLen < pSourceFieldDef->nMinLen) {
-    sprintf(szLastFieldMappingError, "Content too short (minimum length %d)", pSourceFieldDef->nMinLen);
-    return 1;
-  }
+  if (pFieldMapping->csv.nMaxLen > 0 && (int)strlen(pszString) > pFieldMapping->csv.nMaxLen)
+    return false;  // string is too long
 
-  if (pSourceFieldDef->nMaxLen >= 0 && nLen > pSourceFieldDef->nMaxLen) {
-    sprintf(szLastFieldMappingError, "Content too long (maximum length %d)", pSourceFieldDef->nMaxLen);
-    return 2;
-  }
+  if (pFieldMapping->csv.nMinLen > 0 && (int)strlen(pszString) < pFieldMapping->csv.nMinLen)
+    return false;  // string is too short
 
-  if (!CheckRegex(pszSourceValue, pSourceFieldDef->szFormat)) {
-    // source string does not match regular expression
-    int nLen2 = strlen(pSourceFieldDef->szFormat);
-    if (nLen2 > MAX_FORMAT_ERROR_LEN) {
-      nLen2 = MAX_FORMAT_ERROR_LEN;
-      mystrncpy(szShortFormat, pSourceFieldDef->szFormat, nLen2 + 1);
-      strcpy(szShortFormat + nLen2, " ...");
-    }
-    else
-      strcpy(szShortFormat, pSourceFieldDef->szFormat);
+  if (*pFieldMapping->csv.szFormat)
+    bResult = CheckFieldFormat(pszString, &pFieldMapping->csv);
 
-    if (*szShortFormat == ',') {
-      *szShortFormat = '(';
-      nLen2 = strlen(szShortFormat);
-      if (nLen2 > 2 && szShortFormat[nLen2-1] == ',')
-        szShortFormat[nLen2-1] = ')';
-      sprintf(szLastFieldMappingError, "Value not found in list %s", szShortFormat);
-    }
-    else
-      sprintf(szLastFieldMappingError, "Invalid characters found (does not match %s)", szShortFormat);
+  return bResult;
+}
 
-    return 3;
-  }
+//--------------------------------------------------------------------------------------------------------
 
-  // source value is valid
-  if (*pSourceFieldDef->szFormat == ',' && *pDestFieldDef->szFormat == ',' && strcmp(pSourceFieldDef->szFormat, pDestFieldDef->szFormat) != 0) {
-    // source and destination format contain list of valid strings --> map content
-    cpchar pszSourceFormat = pSourceFieldDef->szFormat + 1;
-    cpchar pszDestFormat = pDestFieldDef->szFormat + 1;
-    cpchar pszTemp = NULL;
-    bool bFound = false;
+int ScanNumber(cpchar pszSourceValue, char cSourceDecimalPoint, cpchar pszIgnoreChars, pchar pszDestValue, char cDestDecimalPoint, DecimalNumber *pNumber)
+{
+  // scan number in one pass (no locale, no allocation): optional plus sign at the start, minus sign as first
+  // character not ignored, digits and one decimal point ('\0' = integer)
+  // the string is copied to the destination buffer (optional) with ignored characters removed and decimal
+  // point replaced; the significant digits are stored in pNumber for exact comparisons
+  cpchar pSource = pszSourceValue;
+  pchar pDest = pszDestValue;
+  char c, cIgnore1 = '\0', cIgnore2 = '\0', cIgnore3 = '\0';
+  int i, nRun, nStore, nIntLen = 0, nFractionLen = 0;
+  bool bIntInvalid = false, bFractionInvalid = false, bFirst = true;
+#ifdef USE_SSE2
+  cpchar pBlockStart = pSource;
+  int nEndMask, nValidMask, nDigitMask, nIgnoreMask, nPointMask, nKeepMask;
+  __m128i block, vOffset;
+  __m128i vZero = _mm_setzero_si128();
+  __m128i vDigitZero = _mm_set1_epi8('0');
+  __m128i vNine = _mm_set1_epi8(9);
+#endif
 
-    while (!bFound && *pszSourceFormat && *pszDestFormat) {
-      if (strncmp(pszSourceFormat, pszSourceValue, nLen) == 0 /*&& strlen(pszSourceFormat) > nLen*/ && pszSourceFormat[nLen] == ',') {
-        CopyStringTill(pszDestValue, pszDestFormat, ',');
-        bFound = true;
-      }
-      else {
-        // goto next string in list of source format
-        pszTemp = strchr(pszSourceFormat, ',');
-        pszSourceFormat = pszTemp ? pszTemp+1 : strchr(pszSourceFormat, '\0');
-        // goto next string in list of destination format
-        pszTemp = strchr(pszDestFormat, ',');
-        pszDestFormat = pszTemp ? pszTemp+1 : strchr(pszDestFormat, '\0');
-      }
+  if (pszIgnoreChars && *pszIgnoreChars) {
+    cIgnore1 = pszIgnoreChars[0];
+    if (pszIgnoreChars[1]) {
+      cIgnore2 = pszIgnoreChars[1];
+      cIgnore3 = pszIgnoreChars[2];
     }
   }
-  else {
-    if (*pDestFieldDef->szMappingFormat) {
-      nAddLen = strlen(pDestFieldDef->szMappingFormat) - 3;
-      if (nLen + nAddLen > nMaxLen)
-        return -1;  // destination value buffer is too small
 
-      if (*pDestFieldDef->szMappingFormat == '\'') {
-        // Sample: "'PRAEFIX-'*"
-        strcpy(pszDestValue, pDestFieldDef->szMappingFormat + 1);
-        strcpy(pszDestValue + nAddLen, pszSourceValue);
+  pNumber->bNegative = false;
+  pNumber->bDecimalPoint = false;
+  pNumber->nIntDigits = 0;
+  pNumber->nDigits = 0;
+
+  if (*pSource == '+')
+    pSource++;  // ignore plus sign at the start
+
+  for (; (c = *pSource) != '\0'; pSource++) {
+#ifdef USE_SSE2
+    // classify 16 characters at once (a block within the memory page of the current character is readable)
+    if (pSource >= pBlockStart && ((size_t)pSource & 4095) <= 4096 - 16) {
+      block = _mm_loadu_si128((const __m128i*)pSource);
+      nEndMask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, vZero));
+      nValidMask = nEndMask ? (nEndMask & -nEndMask) - 1 : 0xFFFF;  // characters before the string end
+      vOffset = _mm_sub_epi8(block, vDigitZero);
+      nDigitMask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(vOffset, vNine), vOffset));
+      nIgnoreMask = 0;
+      if (cIgnore1)
+        nIgnoreMask |= _mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(cIgnore1)));
+      if (cIgnore2)
+        nIgnoreMask |= _mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(cIgnore2)));
+      if (cIgnore3)
+        nIgnoreMask |= _mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(cIgnore3)));
+      nPointMask = cSourceDecimalPoint ? _mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(cSourceDecimalPoint))) : 0;
+      nDigitMask &= nValidMask & ~nIgnoreMask;
+      nPointMask &= nValidMask & ~nIgnoreMask;
+
+      if (((nDigitMask | nIgnoreMask | nPointMask) & nValidMask) == nValidMask && (nPointMask & (nPointMask - 1)) == 0 && !(nPointMask && pNumber->bDecimalPoint)) {
+        // only digits, ignored characters and the first decimal point: copy digits and decimal point in one pass
+        if (nDigitMask | nPointMask)
+          bFirst = false;
+        for (nKeepMask = nDigitMask | nPointMask; nKeepMask; nKeepMask &= nKeepMask - 1) {
+          i = GetLowestBit(nKeepMask);
+          c = pSource[i];
+          if (nPointMask & (1 << i)) {
+            pNumber->bDecimalPoint = true;
+            pNumber->nIntDigits = pNumber->nDigits;
+            c = cDestDecimalPoint;
+          }
+          else
+          if (!pNumber->bDecimalPoint) {
+            if (++nIntLen <= MAX_DIGITS && (pNumber->nDigits > 0 || c != '0'))
+              pNumber->acDigits[pNumber->nDigits++] = c;  // no leading zeros
+          }
+          else
+          if (++nFractionLen <= MAX_DIGITS)
+            pNumber->acDigits[pNumber->nDigits++] = c;
+          if (pDest)
+            *pDest++ = c;
+        }
+        pSource += (nEndMask ? GetLowestBit(nEndMask) : 16) - 1;
+        continue;
+      }
+
+      pBlockStart = pSource + 16;  // other characters in this block are checked one by one
+    }
+#endif
+    if (c == cIgnore1 || c == cIgnore2 || c == cIgnore3)
+      continue;  // e.g. spaces or thousands separators
+
+    if ((unsigned int)(c - '0') <= 9) {
+      // copy run of digits at once (digits above the maximum are only counted)
+      nRun = GetDigitSpan(pSource);
+      if (pDest) {
+        memcpy(pDest, pSource, nRun);
+        pDest += nRun;
+      }
+      i = 0;
+      if (!pNumber->bDecimalPoint) {
+        if (pNumber->nDigits == 0)
+          while (i < nRun && pSource[i] == '0')
+            i++;  // no leading zeros
+        nStore = MAX_DIGITS - nIntLen;
+        nIntLen += nRun;
       }
       else {
-        // Sample: "*'-POSTFIX'"
-        strcpy(pszDestValue, pszSourceValue);
-        mystrncpy(pszDestValue + nLen, pDestFieldDef->szMappingFormat + 2, nAddLen);
+        nStore = MAX_DIGITS - nFractionLen;
+        nFractionLen += nRun;
+      }
+      if (nStore > nRun)
+        nStore = nRun;
+      if (nStore > i) {
+        memcpy(pNumber->acDigits + pNumber->nDigits, pSource + i, nStore - i);
+        pNumber->nDigits += nStore - i;
       }
+      pSource += nRun - 1;
+      bFirst = false;
+      continue;
+    }
+
+    if (pDest)
+      *pDest++ = c;
+
+    if (c == '-' && bFirst)
+      pNumber->bNegative = true;
+    else
+    if (c == cSourceDecimalPoint && !pNumber->bDecimalPoint) {
+      pNumber->bDecimalPoint = true;
+      pNumber->nIntDigits = pNumber->nDigits;
+      if (pDest)
+        pDest[-1] = cDestDecimalPoint;
+    }
+    else
+    if (!pNumber->bDecimalPoint) {
+      nIntLen++;
+      bIntInvalid = true;
     }
     else {
-      // no enumeration, so copy source value simply to destination buffer
-      strcpy(pszDestValue, pszSourceValue);
+      nFractionLen++;
+      bFractionInvalid = true;
     }
+
+    bFirst = false;
   }
 
-  return nErrorCode;
+  if (pDest)
+    *pDest = '\0';
+
+  if (!pNumber->bDecimalPoint)
+    pNumber->nIntDigits = pNumber->nDigits;
+
+  // remove trailing zeros of fraction
+  while (pNumber->nDigits > pNumber->nIntDigits && pNumber->acDigits[pNumber->nDigits - 1] == '0')
+    pNumber->nDigits--;
+
+  if (nIntLen > MAX_DIGITS)
+    return NUMBER_INT_TOO_LONG;
+  if (bIntInvalid)
+    return NUMBER_INVALID_CHARS;
+  if (nFractionLen > MAX_DIGITS)
+    return NUMBER_FRACTION_TOO_LONG;
+  if (bFractionInvalid)
+    return NUMBER_INVALID_CHARS;
+
+  return NUMBER_VALID;
 }
-// end of function "MapTextFormat"
+// end of function "ScanNumber"
 
 //--------------------------------------------------------------------------------------------------------
 
-int MapBoolFormat(cpchar pszSourceValue, CPFieldDefinition pSourceFieldDef, pchar pszDestValue, CPFieldDefinition pDestFieldDef)
+int CompareDecimalNumbers(DecimalNumber const *pNumber1, DecimalNumber const *pNumber2)
 {
-  cpchar pszSourceFormat = pSourceFieldDef->szFormat;
-  cpchar pszDestFormat = pDestFieldDef->szFormat;
-  cpchar pPos = NULL;
-  char szShortFormat[MAX_FORMAT_ERROR_SIZE+4];
+  // exact comparison of scanned numbers (-1 = less, 0 = equal, 1 = greater)
+  bool bNegative1 = pNumber1->bNegative && pNumber1->nDigits > 0;  // -0 is zero
+  bool bNegative2 = pNumber2->bNegative && pNumber2->nDigits > 0;
+  int nResult;
 
-  if (!pszSourceFormat || !*pszSourceFormat)
-    pszSourceFormat = szDefaultBooleanFormat;
+  if (bNegative1 != bNegative2)
+    return bNegative1 ? -1 : 1;
 
-  if (!pszDestFormat || !*pszDestFormat)
-    pszDestFormat = szDefaultBooleanFormat;
+  // compare absolute values (more digits before decimal point, then digit by digit)
+  if (pNumber1->nIntDigits != pNumber2->nIntDigits)
+    nResult = (pNumber1->nIntDigits < pNumber2->nIntDigits) ? -1 : 1;
+  else {
+    nResult = memcmp(pNumber1->acDigits, pNumber2->acDigits, (pNumber1->nDigits < pNumber2->nDigits) ? pNumber1->nDigits : pNumber2->nDigits);
+    if (nResult == 0 && pNumber1->nDigits != pNumber2->nDigits)
+      nResult = (pNumber1->nDigits < pNumber2->nDigits) ? -1 : 1;
+    nResult = (nResult < 0) ? -1 : (nResult > 0) ? 1 : 0;
+  }
 
-  *szLastFieldMappingError = '\0';
+  return bNegative1 ? -nResult : nResult;
+}
 
-  if (!*pszSourceValue && !pSourceFieldDef->bMandatory)
-    return 0;  // empty value is allowed for optional fields
+//--------------------------------------------------------------------------------------------------------
 
-  if (!CheckRegex(pszSourceValue, pszSourceFormat)) {
-    int nLen = strlen(pSourceFieldDef->szFormat);
-    if (nLen > MAX_FORMAT_ERROR_LEN) {
-      nLen = MAX_FORMAT_ERROR_LEN;
-      mystrncpy(szShortFormat, pSourceFieldDef->szFormat, nLen + 1);
-      strcpy(szShortFormat + nLen, " ...");
-    }
-    else
-      strcpy(szShortFormat, pSourceFieldDef->szFormat);
+void GetScaledDecimalNumber(long long nMantissa, int nScale, DecimalNumber *pNumber)
+{
+  // decimal number with value nMantissa / 10^nScale (e.g. decoded number of typed column)
+  char szDigits[32];
+  int nLen;
+  unsigned long long nAbsolute = (nMantissa < 0) ? 0ULL - (unsigned long long)nMantissa : (unsigned long long)nMantissa;
+
+  if (nScale < 0 || nScale > 18)
+    nScale = (nScale < 0) ? 0 : 18;  // decoded numbers have up to 18 fraction digits (DecodeTypedNumber)
+  nLen = sprintf(szDigits, "%0*llu", nScale + 1, nAbsolute);
+  pNumber->bNegative = (nMantissa < 0);
+  pNumber->bDecimalPoint = (nScale > 0);
+  pNumber->nIntDigits = 0;
+  pNumber->nDigits = 0;
+  for (int i = 0; i < nLen; i++) {
+    if (pNumber->nDigits > 0 || szDigits[i] != '0' || i >= nLen - nScale)
+      pNumber->acDigits[pNumber->nDigits++] = szDigits[i];
+    if (i == nLen - nScale - 1)
+      pNumber->nIntDigits = pNumber->nDigits;
+  }
+  while (pNumber->nDigits > pNumber->nIntDigits && pNumber->acDigits[pNumber->nDigits - 1] == '0')
+    pNumber->nDigits--;
+}
 
-    *szShortFormat = '(';
-    nLen = strlen(szShortFormat);
-    if (nLen > 2 && szShortFormat[nLen-1] == ',')
-      szShortFormat[nLen-1] = ')';
-    sprintf(szLastFieldMappingError, "Value not found in list %s", szShortFormat);
-    return 3;
-  }
+//--------------------------------------------------------------------------------------------------------
 
-  // source value is valid
-  pPos = strchr(pszDestFormat+1, ',');
-  if (!pPos) {
-    sprintf(szLastFieldMappingError, "Second string missing in destination format %s", pszDestFormat);
-    return 4;
+double GetDecimalNumberValue(DecimalNumber const *pNumber)
+{
+  // value as double (exact digits for up to 15 significant digits, otherwise rounded by strtod)
+  static const double afPowerOfTen[23] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+  char szNumber[2 * MAX_DIGITS + 8];
+  long long nMantissa = 0;
+  double fValue;
+  int i, nScale = pNumber->nDigits - pNumber->nIntDigits;
+
+  if (pNumber->nDigits <= 15 && nScale <= 22 && pNumber->nIntDigits <= 15) {
+    for (i = 0; i < pNumber->nDigits; i++)
+      nMantissa = 10 * nMantissa + (pNumber->acDigits[i] - '0');
+    fValue = (double)nMantissa / afPowerOfTen[nScale];
+  }
+  else {
+    // scientific notation is independent of the decimal point of the locale
+    memcpy(szNumber, pNumber->acDigits, pNumber->nDigits);
+    sprintf(szNumber + pNumber->nDigits, "e%d", -nScale);
+    fValue = strtod(szNumber, NULL);
   }
 
-  // source value matching first or second string defined in source format ?
-  if (strncmp(pszSourceValue, pszSourceFormat + 1, strlen(pszSourceValue)) == 0)
-    CopyStringTill(pszDestValue, pszDestFormat + 1, ',');  // copy first string defined in destination format (e.g. "true")
-  else
-    CopyStringTill(pszDestValue, pPos + 1, ',');  // copy second string defined in destination format (e.g. "false")
+  return pNumber->bNegative ? -fValue : fValue;
+}
 
-  return 0;  // success
+//--------------------------------------------------------------------------------------------------------
+
+int MapIntFormat(cpchar pszSourceValue, cpchar pszSourceFormat, pchar pszDestValue, cpchar pszDestFormat, int nMaxLen)
+{
+  DecimalNumber Number;
+
+  if ((int)strlen(pszSourceValue) > nMaxLen)
+    return -1;  // destination value buffer is too small
+
+  switch (ScanNumber(pszSourceValue, '\0', " ", pszDestValue, '\0', &Number)) {
+    case NUMBER_INT_TOO_LONG:
+      sprintf(szLastFieldMappingError, "Number too long (maximum digits %d)", MAX_DIGITS);
+      return 2;
+    case NUMBER_INVALID_CHARS:
+      strcpy(szLastFieldMappingError, "Invalid number (invalid characters found)");
+      return 3;
+  }
+
+  return 0;
 }
-// end of function "MapBoolFormat"
 
 //--------------------------------------------------------------------------------------------------------
 
-bool ConvertNumber(cpchar szValue, char cType, int *pnValue, double *pfValue)
+int CheckMinMaxValues(cpchar pszValue, CPFieldDefinition pFieldDefinition)
 {
-  int i, nErrorCode;
-  int nValue;
-  double fValue;
-  bool bOK = FALSE;
+  // check normalized value (decimal point '.', no thousands separators) with exact limits
+  DecimalNumber Number;
 
-  *szLastError = '\0';
+  if (!pFieldDefinition->pMinLimit && !pFieldDefinition->pMaxLimit)
+    return 0;
 
-  if (cType == 'I'/*INTEGER*/) {
-    nErrorCode = MapIntFormat(szValue, NULL, szTempConvertNumber, NULL, 11);
-    if (nErrorCode == 0) {
-      i = sscanf(szValue, "%d", &nValue);
-      if (i == 0)
-        nErrorCode = 3;
+  if (ScanNumber(pszValue, (pFieldDefinition->cType == 'N'/*NUMBER*/) ? '.' : '\0', " ", NULL, '\0', &Number) != NUMBER_VALID)
+    return 0;  // invalid value is reported by MapIntFormat or MapNumberFormat
+
+  if (pFieldDefinition->cType == 'I'/*INTEGER*/) {
+    if (pFieldDefinition->pMinLimit && CompareDecimalNumbers(&Number, &pFieldDefinition->pMinLimit->Number) < 0) {
+      sprintf(szLastFieldMappingError, "Integer value below limit %d", pFieldDefinition->nMinValue);
+      return 4;
     }
-    if (nErrorCode > 0)
-      strcpy(szLastError, "Invalid integer value");
-    else {
-      *pnValue = nValue;
-      bOK = TRUE;
+    if (pFieldDefinition->pMaxLimit && CompareDecimalNumbers(&Number, &pFieldDefinition->pMaxLimit->Number) > 0) {
+      sprintf(szLastFieldMappingError, "Integer value above limit %d", pFieldDefinition->nMaxValue);
+      return 4;
     }
   }
 
-  if (cType == 'N'/*NUMBER*/) {
-    nErrorCode = MapNumberFormat(szValue, cDecimalPoint, NULL, szTempConvertNumber, '.', NULL, MAX_NUMBER_VALUE_LEN);
-    if (nErrorCode == 0) {
-      i = sscanf(szValue, "%lf", &fValue);
-      if (i == 0)
-        nErrorCode = 3;
+  if (pFieldDefinition->cType == 'N'/*NUMBER*/) {
+    if (pFieldDefinition->pMinLimit && CompareDecimalNumbers(&Number, &pFieldDefinition->pMinLimit->Number) < 0) {
+      sprintf(szLastFieldMappingError, "Number value below limit %lf", pFieldDefinition->fMinValue);
+      return 4;
     }
-    if (nErrorCode > 0)
-      strcpy(szLastError, "Invalid number value");
-    else {
-      *pfValue = fValue;
-      bOK = TRUE;
+    if (pFieldDefinition->pMaxLimit && CompareDecimalNumbers(&Number, &pFieldDefinition->pMaxLimit->Number) > 0) {
+      sprintf(szLastFieldMappingError, "Number value above limit %lf", pFieldDefinition->fMaxValue);
+      return 4;
     }
   }
 
-  return bOK;
+  return 0;
 }
-// end of function "ConvertNumber"
+// end of function "CheckMinMaxValues"
 
 //--------------------------------------------------------------------------------------------------------
 
-int MapCsvToXmlValue(FieldMapping const *pFieldMapping, cpchar pCsvValue, pchar pXmlValue, int nMaxLen)
+int InsertThousandsSeparators(pchar pszValue, char cSeparator, int nMaxLen)
 {
-  int nErrorCode = 0;
-  char szErrorMessage[MAX_ERROR_MESSAGE_SIZE];
-  cpchar pszFormat = pFieldMapping->xml.szFormat;
-  LinkedCsvFile *pLinkedCsvFile = aLinkedCsvFile + pFieldMapping->nCsvFileIndex;
-
-  // mandatory field without content ?
-  if (!*pCsvValue && pFieldMapping->csv.bMandatory) {
-    LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pFieldMapping->xml.szContent, pCsvValue, "Mandatory field empty");
-    return 1;
-  }
-
-  // optional field without content ?
-  if (!*pCsvValue && !pFieldMapping->csv.bMandatory)
-    return 0;  // nothing to do
-
-  if (pFieldMapping->csv.cType == 'B'/*BOOLEAN*/ && pFieldMapping->xml.cType == 'B'/*BOOLEAN*/) {
-    // map boolean value
-    nErrorCode = MapBoolFormat(pCsvValue, &pFieldMapping->csv, pXmlValue, &pFieldMapping->xml);
-    if (nErrorCode > 0)
-      LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pFieldMapping->xml.szContent, pCsvValue, szLastFieldMappingError);
-  }
-
-  if (pFieldMapping->csv.cType == 'D'/*DATE*/ && pFieldMapping->xml.cType == 'D'/*DATE*/) {
-    // map date value
-    if ((int)strlen(pszFormat) <= nMaxLen)
-      nErrorCode = MapDateFormat(pCsvValue, pFieldMapping->csv.szFormat, pXmlValue, pszFormat);
-    else
-      nErrorCode = -1;
-
-    if (nErrorCode > 0) {
-      sprintf(szErrorMessage, "Invalid date (does not match '%s')", pFieldMapping->csv.szFormat);
-      LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pFieldMapping->xml.szContent, pCsvValue, szErrorMessage);
-    }
-  }
+  // insert separator between groups of three digits before the decimal point (-1 = buffer too small)
+  pchar pDigits = (*pszValue == '-') ? pszValue + 1 : pszValue;
+  int i, nDigits = 0, nSeparators, nLen = strlen(pszValue);
 
-  if (pFieldMapping->csv.cType == 'I'/*INTEGER*/ && pFieldMapping->xml.cType == 'I'/*INTEGER*/) {
-    nErrorCode = MapIntFormat(pCsvValue, pFieldMapping->csv.szFormat, pXmlValue, pszFormat, nMaxLen);
-    if (nErrorCode == 0)
-      nErrorCode = CheckMinMaxValues(pXmlValue, &pFieldMapping->csv);
-    if (nErrorCode > 0) {
-      LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pFieldMapping->xml.szContent, pCsvValue, szLastFieldMappingError);
-      *pXmlValue = '\0';
-    }
-  }
+  while ((unsigned int)(pDigits[nDigits] - '0') <= 9)
+    nDigits++;
 
-  if (pFieldMapping->csv.cType == 'N'/*NUMBER*/ && pFieldMapping->xml.cType == 'N'/*NUMBER*/) {
-    nErrorCode = MapNumberFormat(pCsvValue, cDecimalPoint, pFieldMapping->csv.szFormat, pXmlValue, '.', pszFormat, nMaxLen);
-    if (nErrorCode == 0)
-      nErrorCode = CheckMinMaxValues(pXmlValue, &pFieldMapping->csv);
-    if (nErrorCode > 0) {
-      LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pFieldMapping->xml.szContent, pCsvValue, szLastFieldMappingError);
-      *pXmlValue = '\0';
-    }
-  }
+  nSeparators = (nDigits - 1) / 3;
+  if (nSeparators <= 0)
+    return 0;
+  if (nLen + nSeparators > nMaxLen)
+    return -1;
 
-  if (pFieldMapping->csv.cType == 'T'/*TEXT*/ && pFieldMapping->xml.cType == 'T'/*TEXT*/) {
-    nErrorCode = MapTextFormat(pCsvValue, &pFieldMapping->csv, pXmlValue, &pFieldMapping->xml, nMaxLen);
-    if (nErrorCode > 0)
-      LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pFieldMapping->xml.szContent, pCsvValue, szLastFieldMappingError);
+  // move digits from right to left
+  memmove(pDigits + nDigits + nSeparators, pDigits + nDigits, nLen - (pDigits - pszValue) - nDigits + 1);
+  for (i = nDigits - 1; i >= 0; i--) {
+    pDigits[i + nSeparators] = pDigits[i];
+    if ((nDigits - i) % 3 == 0 && i > 0)
+      pDigits[i + --nSeparators] = cSeparator;
   }
 
-  return nErrorCode;
+  return 0;
 }
-// end of function "MapCsvToXmlValue"
 
 //--------------------------------------------------------------------------------------------------------
 
-int MapXmlToCsvValue(FieldMapping const *pFieldMapping, cpchar pXmlValue, cpchar pXPath, pchar pCsvValue, int nMaxLen)
+int MapNumberFormat(cpchar pszSourceValue, char cSourceDecimalPoint, cpchar pszSourceFormat, pchar pszDestValue, char cDestDecimalPoint, cpchar pszDestFormat, int nMaxLen)
 {
-  int nErrorCode = 0;
-  char szErrorMessage[MAX_ERROR_MESSAGE_SIZE];
-  cpchar pszFromFormat = pFieldMapping->xml.szFormat;
-  cpchar pszToFormat = pFieldMapping->csv.szFormat;
-  LinkedCsvFile *pLinkedCsvFile = aLinkedCsvFile + pFieldMapping->nCsvFileIndex;
+  char szIgnoreChars[4] = "";
+  DecimalNumber Number;
+  int nResult;
 
-  // mandatory field without content ?
-  if (!*pXmlValue && pFieldMapping->xml.bMandatory) {
-    LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pXPath, pXmlValue, "Mandatory field missing or empty");
-    return 1;
-  }
+  if ((int)strlen(pszSourceValue) > nMaxLen)
+    return -1;  // destination value buffer is too small
 
-  if (pFieldMapping->csv.cType == 'B'/*BOOLEAN*/ && pFieldMapping->xml.cType == 'B'/*BOOLEAN*/) {
-    // map boolean value
-    nErrorCode = MapBoolFormat(pXmlValue, &pFieldMapping->xml, pCsvValue, &pFieldMapping->csv);
-    if (nErrorCode > 0)
-      LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pXPath, pXmlValue, szLastFieldMappingError);
+  if (convDir == CSV2XML) {
+    // ignore 1000-delimiters of csv number
+    szIgnoreChars[0] = (cSourceDecimalPoint == '.') ? ',' : '.';
+    szIgnoreChars[1] = ' ';
+    if (cThousandsSeparator != cSourceDecimalPoint)
+      szIgnoreChars[2] = cThousandsSeparator;
   }
 
-  if (pFieldMapping->csv.cType == 'D'/*DATE*/ && pFieldMapping->xml.cType == 'D'/*DATE*/) {
-    // map date value
-    if (pszFromFormat == NULL || strlen(pszFromFormat) < 10)
-      pszFromFormat = szXmlDateFormat;
-    if (pszToFormat == NULL)
-      pszToFormat = szCsvDefaultDateFormat;
-
-    if ((int)strlen(pszToFormat) <= nMaxLen)
-      nErrorCode = MapDateFormat(pXmlValue, pszFromFormat, pCsvValue, pszToFormat);
+  nResult = ScanNumber(pszSourceValue, cSourceDecimalPoint, szIgnoreChars, pszDestValue, cDestDecimalPoint, &Number);
+  if (nResult == NUMBER_INT_TOO_LONG) {
+    if (Number.bDecimalPoint)
+      sprintf(szLastFieldMappingError, "Number too long (maximum digits %d before decimal point)", MAX_DIGITS);
     else
-      nErrorCode = -1;
-
-    if (nErrorCode > 0) {
-      sprintf(szErrorMessage, "Invalid date (does not match '%s')", pszFromFormat);
-      LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pXPath, pXmlValue, szErrorMessage);
-    }
+      sprintf(szLastFieldMappingError, "Number too long (maximum digits %d)", MAX_DIGITS);
+    return 2;
   }
-
-  if (pFieldMapping->csv.cType == 'I'/*INTEGER*/ && pFieldMapping->xml.cType == 'I'/*INTEGER*/) {
-    // map integer value
-    nErrorCode = CheckMinMaxValues(pXmlValue, &pFieldMapping->xml);
-    if (nErrorCode == 0)
-      nErrorCode = MapIntFormat(pXmlValue, pFieldMapping->xml.szFormat, pCsvValue, pFieldMapping->csv.szFormat, nMaxLen);
-    if (nErrorCode > 0)
-      LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pXPath, pXmlValue, szLastFieldMappingError);
+  if (nResult == NUMBER_FRACTION_TOO_LONG) {
+    sprintf(szLastFieldMappingError, "Number too long (maximum digits %d after decimal point)", MAX_DIGITS);
+    return 2;
   }
-
-  if (pFieldMapping->csv.cType == 'N'/*NUMBER*/ && pFieldMapping->xml.cType == 'N'/*NUMBER*/) {
-    // map xml number to csv number format
-    nErrorCode = CheckMinMaxValues(pXmlValue, &pFieldMapping->xml);
-    if (nErrorCode == 0)
-      nErrorCode = MapNumberFormat(pXmlValue, '.', pFieldMapping->xml.szFormat, pCsvValue, cDecimalPoint, pszToFormat, nMaxLen);
-    if (nErrorCode > 0)
-      LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pXPath, pXmlValue, szLastFieldMappingError);
+  if (nResult == NUMBER_INVALID_CHARS) {
+    sprintf(szLastFieldMappingError, "Invalid number (invalid characters found, decimal point is '%c')", cSourceDecimalPoint);
+    return 3;
   }
 
-  if (pFieldMapping->csv.cType == 'T'/*TEXT*/ && pFieldMapping->xml.cType == 'T'/*TEXT*/) {
-    // map text value
-    nErrorCode = MapTextFormat(pXmlValue, &pFieldMapping->xml, pCsvValue, &pFieldMapping->csv, nMaxLen);
-    if (nErrorCode > 0)
-      LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pXPath, pXmlValue, szLastFieldMappingError);
-  }
+  // write csv number with thousands separator (optional)
+  if (convDir == XML2CSV && cThousandsSeparator && cThousandsSeparator != cDestDecimalPoint)
+    return InsertThousandsSeparators(pszDestValue, cThousandsSeparator, nMaxLen);
 
-  return nErrorCode;
+  return 0;
 }
-// end of function "MapXmlToCsvValue"
+// end of function "MapNumberFormat"
 
 //--------------------------------------------------------------------------------------------------------
 
-/*
-CSV_OP CSV_CONTENT    CSV_MO CSV_TYPE	CSV_MIN_LEN	CSV_MAX_LEN	CSV_FORMAT	CSV_DEFAULT	XML_OP	XML_CONTENT	XML_MO	XML_TYPE	XML_MIN_LEN	XML_MAX_LEN	XML_FORMAT	XML_DEFAULT
-FIX    Constant Value M      TEXT	3	3			FIX	Constant Value	M	TEXT	3	3
-VAR    Variables      O      INTEGER					VAR	Macro	O	INTEGER
-MAP    Column Name    M NUMBER					MAP	XPATH	M	NUMBER
-      DATE			DD.MM.YYYY					DATE
-      DATETIME								DATETIME
-      BOOLEAN			Ja/Nein					BOOLEAN
-*/
+void CompileDateCodec(DateCodec *pCodec, cpchar pszFormat)
+{
+  // compile date/time format (e.g. "DD.MM.YYYY" or "YYYY-MM-DDThh:mm:ss") into positions of the components
+  static const char *aszComponent[DATE_COMPONENTS] = { "DD", "MM", "YYYY", "hh", "mm", "ss" };
+  cpchar pPos = NULL;
+  int i;
 
-//--------------------------------------------------------------------------------------------------------
+  if (!pszFormat)
+    pszFormat = szEmptyString;
 
-char *GetNextLine(pchar *ppReadPos)
-{
-  char *pReadPos = *ppReadPos;
-  char *pResult = pReadPos;
+  pCodec->pszFormat = pszFormat;
+  pCodec->nLen = strlen(pszFormat);
 
-  if (pReadPos && *pReadPos) {
-    while (strchr("\r\n", *pReadPos) == NULL)
-      pReadPos++;
-    if (*pReadPos) {
-      *pReadPos++ = '\0';
-      if (*pReadPos == '\n')
-        pReadPos++;
-    }
-    *ppReadPos = pReadPos;
+  for (i = 0; i < DATE_COMPONENTS; i++) {
+    pPos = strstr(pszFormat, aszComponent[i]);
+    pCodec->anOffset[i] = pPos ? (int)(pPos - pszFormat) : -1;
+    pCodec->anWidth[i] = strlen(aszComponent[i]);
   }
-  else
-    pResult = NULL;
 
-  return pResult;
+  if (pCodec->anOffset[DATE_YEAR] < 0) {
+    // year with two digits
+    pPos = strstr(pszFormat, "YY");
+    pCodec->anOffset[DATE_YEAR] = pPos ? (int)(pPos - pszFormat) : -1;
+    pCodec->anWidth[DATE_YEAR] = 2;
+  }
+
+  // positions of delimiters (all characters not used for date components)
+  pCodec->nDelimiters = 0;
+  for (i = 0; i < pCodec->nLen && pCodec->nDelimiters >= 0; i++)
+    if (!strchr("DMYhms", pszFormat[i])) {
+      if (pCodec->nDelimiters < MAX_DATE_DELIMITERS)
+        pCodec->anDelimiterPos[pCodec->nDelimiters++] = i;
+      else
+        pCodec->nDelimiters = -1;
+    }
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-int GetFields(char *pLine, char cDelimiter, pchar *aField, int nMaxFields, bool *pbColumnQuoted = NULL)
+int ParseDateDigits(cpchar pDigits, int nWidth)
 {
-  // parse line and returns pointers to field contents in aField array
-  char *pPos = pLine;
-  int nFields = 0;
-  char *pDelimiter = NULL;
-  char *pEnd = NULL;
-  char *pNext = NULL;
-
-  // skip spaces and tabs at the beginning of the field
-  while (*pPos && strchr(szIgnoreChars, *pPos))
-    pPos++;
-
-  while (*pPos && nFields < nMaxFields) {
-    if (*pPos == '"') {
-      // store flag that value has been quoted
-      if (pbColumnQuoted)
-        pbColumnQuoted[nFields] = true;
+  // get value of date component (characters other than digits are converted like atoi, e.g. " 5" or "-1")
+  int nValue = 0;
+  unsigned int nDigit;
+  char szComponent[8];
+
+  for (int i = 0; i < nWidth; i++) {
+    nDigit = (unsigned char)pDigits[i] - '0';
+    if (nDigit > 9) {
+      memcpy(szComponent, pDigits, nWidth);
+      szComponent[nWidth] = '\0';
+      return atoi(szComponent);
+    }
+    nValue = 10 * nValue + nDigit;
+  }
 
-      // store start address of current field
-      aField[nFields++] = ++pPos;
+  return nValue;
+}
 
-      // search for end of string
-      pEnd = strchr(pPos, '"');
-      if (pEnd) {
-        *pEnd = '\0';
-        pPos = pEnd + 1;
+//--------------------------------------------------------------------------------------------------------
 
-        // search for delimiter
-        pDelimiter = strchr(pPos, cDelimiter);
-        if (pDelimiter)
-          pPos = pDelimiter + 1;
-        else
-          pPos = strchr(pPos, '\0');  // end of line
-      }
-      else
-        pPos = strchr(pPos, '\0');  // end of line
-    }
-    else {
-      // store start address of current field
-      aField[nFields++] = pPos;
+int DecodeDate(cpchar pszValue, DateCodec const *pCodec, int anValue[DATE_COMPONENTS])
+{
+  // get date components of value with compiled format
+  // returns 1 if the length does not match, 2 if a delimiter or component is invalid (component is limited then)
+  static const int anDefault[DATE_COMPONENTS] = { 1, 1, 2000, 0, 0, 0 };
+  int i, nErrorCode = 0;
+  int const *pnOffset = pCodec->anOffset;
 
-      // search for next delimiter
-      pDelimiter = strchr(pPos, cDelimiter);
+  if ((int)strlen(pszValue) != pCodec->nLen)
+    return 1;
 
-      // get end of current field
-      if (pDelimiter) {
-        pEnd = pDelimiter;
-        pNext = pDelimiter + 1;
-      }
-      else {
-        pEnd = strchr(pPos, '\0');  // end of line
-        pNext = pEnd;
-      }
+  for (i = 0; i < DATE_COMPONENTS; i++)
+    anValue[i] = (pnOffset[i] >= 0) ? ParseDateDigits(pszValue + pnOffset[i], pCodec->anWidth[i]) : anDefault[i];
 
-      // skip spaces and tabs at the end of the field
-      while (pEnd > pPos && strchr(szIgnoreChars, *(pEnd-1)))
-        pEnd--;
-      *pEnd = '\0';
+  if (pnOffset[DATE_YEAR] >= 0 && pCodec->anWidth[DATE_YEAR] == 2)
+    anValue[DATE_YEAR] += 2000;
 
-      pPos = pNext;
-    }
+  if (anValue[DATE_DAY] < 1) { anValue[DATE_DAY] = 1; nErrorCode = 2; }
+  if (anValue[DATE_DAY] > 31) { anValue[DATE_DAY] = 31; nErrorCode = 2; }
+  if (anValue[DATE_MONTH] < 1) { anValue[DATE_MONTH] = 1; nErrorCode = 2; }
+  if (anValue[DATE_MONTH] > 12) { anValue[DATE_MONTH] = 12; nErrorCode = 2; }
+  if (pCodec->anWidth[DATE_YEAR] == 4) {
+    if (anValue[DATE_YEAR] < 1900) { anValue[DATE_YEAR] = 1900; nErrorCode = 2; }
+    if (anValue[DATE_YEAR] > 2150) { anValue[DATE_YEAR] = 2150; nErrorCode = 2; }
+  }
+  if (anValue[DATE_DAY] > GetDaysOfMonth(anValue[DATE_YEAR], anValue[DATE_MONTH])) {
+    // day does not exist in this month (e.g. 31.04. or 29.02. in a year that is no leap year)
+    anValue[DATE_DAY] = GetDaysOfMonth(anValue[DATE_YEAR], anValue[DATE_MONTH]);
+    nErrorCode = 2;
+  }
+  if ((unsigned int)anValue[DATE_HOUR] > 23) { anValue[DATE_HOUR] = 0; nErrorCode = 2; }
+  if ((unsigned int)anValue[DATE_MINUTE] > 59) { anValue[DATE_MINUTE] = 0; nErrorCode = 2; }
+  if ((unsigned int)anValue[DATE_SECOND] > 59) { anValue[DATE_SECOND] = 0; nErrorCode = 2; }
 
-    // skip spaces and tabs at the beginning of the next field
-    while (*pPos && strchr(szIgnoreChars, *pPos))
-      pPos++;
+  // check delimiters
+  if (pCodec->nDelimiters >= 0) {
+    for (i = 0; i < pCodec->nDelimiters; i++)
+      if (pszValue[pCodec->anDelimiterPos[i]] != pCodec->pszFormat[pCodec->anDelimiterPos[i]])
+        nErrorCode = 2;  // Invalid delimiter found
+  }
+  else {
+    for (i = 0; i < pCodec->nLen; i++)
+      if (!strchr("DMYhms", pCodec->pszFormat[i]) && pCodec->pszFormat[i] != pszValue[i])
+        nErrorCode = 2;  // Invalid delimiter found
   }
 
-  return nFields;
+  return nErrorCode;
 }
-// end of function "GetFields"
+// end of function "DecodeDate"
 
 //--------------------------------------------------------------------------------------------------------
 
-// OLD VERSION (still in use for csv conditions):
-void OldParseCondition(cpchar pszCondition, pchar pszConditionBuffer, pchar *ppszLeftPart, pchar *ppszOperator, pchar *ppszRightPart)
+void EncodeDate(DateCodec const *pCodec, pchar pszDestValue, int const anValue[DATE_COMPONENTS])
 {
-  // Parses conditions like "CCY != FUND_CCY" or "48_* = '1'" (mandatory space before and after operator !)
-  //   or like "(@fromCcy = Funds/Fund/FundDynamicData/Portfolios/Portfolio/Positions/Position/Currency and @toCcy = Funds/Fund/Currency and @mulDiv = 'D') or (@fromCcy = Funds/Fund/Currency and @toCcy = Funds/Fund/FundDynamicData/Portfolios/Portfolio/Positions/Position/Currency and @mulDiv = 'M')" ?
-  // Supported operators: "=", "!=", "<", ">"
-  //
-  // Input Parameters:
-  //   pszCondition .... string containing the condition (e.g. "CCY != FUND_CCY")
-  //   pszConditionBuffer .... buffer for content of result strings (must have size MAX_CONDITION_SIZE!)
-  // 
-  // Result parameters:
-  //   *ppszLeftPart .... pointer to the left part of the condition (e.g. "CCY")
-  //   *ppszOperator .... pointer to the operator of the condition (e.g. "!=")
-  //   *ppszRightPart ... pointer to the right part of the condition (e.g. "FUND_CCY")
-  //
-  char szOperator[5];
-  char *pPos;
+  // write date/time components to positions defined by the compiled destination format
+  int i, j, nValue;
+  pchar pDigits;
+
+  memcpy(pszDestValue, pCodec->pszFormat, pCodec->nLen + 1);
+
+  for (i = 0; i < DATE_COMPONENTS; i++)
+    if (pCodec->anOffset[i] >= 0) {
+      // last digits of the value (e.g. year with two digits)
+      nValue = anValue[i];
+      pDigits = pszDestValue + pCodec->anOffset[i];
+      for (j = pCodec->anWidth[i] - 1; j >= 0; j--) {
+        pDigits[j] = (char)('0' + nValue % 10);
+        nValue /= 10;
+      }
+    }
+}
 
-  // initialize result parameters
-  *ppszLeftPart = NULL;
-  *ppszOperator = NULL;
-  *ppszRightPart = NULL;
+//--------------------------------------------------------------------------------------------------------
 
-	if (strlen(pszCondition) > MAX_CONDITION_LEN)
-		return;
+int MapDateCodec(cpchar pszSourceValue, DateCodec const *pSourceCodec, pchar pszDestValue, DateCodec const *pDestCodec)
+{
+  int anValue[DATE_COMPONENTS];
+  int nErrorCode = DecodeDate(pszSourceValue, pSourceCodec, anValue);
 
-	strcpy(pszConditionBuffer, pszCondition);
+  // build result date
+  if (nErrorCode != 1)
+    EncodeDate(pDestCodec, pszDestValue, anValue);
 
-  // search for operator !=
-  strcpy(szOperator, " != ");
-  pPos = strstr(pszConditionBuffer, szOperator);
+  return nErrorCode;
+}
 
-  if (!pPos) {
-    // search for operator =
-    strcpy(szOperator, " = ");
-    pPos = strstr(pszConditionBuffer, szOperator);
-  }
+//--------------------------------------------------------------------------------------------------------
 
-  if (!pPos) {
-    // search for operator <
-    strcpy(szOperator, " < ");
-    pPos = strstr(pszConditionBuffer, szOperator);
-  }
+int MapDateFormat(cpchar pszSourceValue, cpchar pszSourceFormat, pchar pszDestValue, cpchar pszDestFormat)
+{
+  // map date with formats not compiled before
+  DateCodec SourceCodec, DestCodec;
 
-  if (!pPos) {
-    // search for operator >
-    strcpy(szOperator, " > ");
-    pPos = strstr(pszConditionBuffer, szOperator);
-  }
+  CompileDateCodec(&SourceCodec, pszSourceFormat);
+  CompileDateCodec(&DestCodec, pszDestFormat);
 
-  if (pPos) {
-    // operator found
-    *ppszLeftPart = pszConditionBuffer;
-    *pPos++ = '\0';
-    *ppszOperator = pPos;
-    pPos += strlen(szOperator) - 2;
-    *pPos++ = '\0';
-    *ppszRightPart = pPos;
-  }
+  return MapDateCodec(pszSourceValue, &SourceCodec, pszDestValue, &DestCodec);
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-int ParseSimpleCondition(pchar pszCondition, PSimpleCondition pSimpleCondition)
+int MapTextFormat(cpchar pszSourceValue, CPFieldDefinition pSourceFieldDef, pchar pszDestValue, CPFieldDefinition pDestFieldDef, int nMaxLen)
 {
-  // Parses conditions like "CCY != FUND_CCY" or "48_* = '1'" (mandatory space before and after operator !)
-  // Supported operators: "=", "!=", "<", ">"
-  //
-  // Input Parameters:
-  //   pszCondition .... string containing the condition (e.g. "CCY != FUND_CCY")
-  // 
-  // Result parameters:
-  //   *ppszLeftPart .... pointer to the left part of the condition (e.g. "CCY")
-  //   *ppszOperator .... pointer to the operator of the condition (e.g. "!=")
-  //   *ppszRightPart ... pointer to the right part of the condition (e.g. "FUND_CCY")
-  //
-  char szOperator[5];
-  char *pPos;
-  int len;
+  char szShortFormat[MAX_FORMAT_ERROR_SIZE+4];
+  int nLen = (int)strlen(pszSourceValue);
+  int nErrorCode = 0;
+  int nAddLen;
 
-  // initialize result parameters
-  pSimpleCondition->szLeftPart = NULL;
-  pSimpleCondition->szOperator = NULL;
-  pSimpleCondition->szRightPart = NULL;
+  *szLastFieldMappingError = '\0';
+  *pszDestValue = '\0';
 
-  // search for operator !=
-  strcpy(szOperator, " != ");
-  pPos = strstr(pszCondition, szOperator);
+  //if (strcmp(pDestFieldDef->szContent, "CCY") == 0)
+  //  nErrorCode = 0;  // for debugging purposes only!
 
-  if (!pPos) {
-    // search for operator =
-    strcpy(szOperator, " = ");
-    pPos = strstr(pszCondition, szOperator);
+  if (!*pszSourceValue && !pSourceFieldDef->bMandatory)
+    return 0;  // empty value is allowed for optional fields
+
+  if (nLen > nMaxLen)
+    return -1;  // destination value buffer is too small
+
+  if (nLen < pSourceFieldDef->nMinLen) {
+    sprintf(szLastFieldMappingError, "Content too short (minimum length %d)", pSourceFieldDef->nMinLen);
+    return 1;
   }
 
-  if (!pPos) {
-    // search for operator <
-    strcpy(szOperator, " < ");
-    pPos = strstr(pszCondition, szOperator);
+  if (pSourceFieldDef->nMaxLen >= 0 && nLen > pSourceFieldDef->nMaxLen) {
+    sprintf(szLastFieldMappingError, "Content too long (maximum length %d)", pSourceFieldDef->nMaxLen);
+    return 2;
   }
 
-  if (!pPos) {
-    // search for operator >
-    strcpy(szOperator, " > ");
-    pPos = strstr(pszCondition, szOperator);
-  }
+  if (!CheckFieldFormat(pszSourceValue, pSourceFieldDef)) {
+    // source string does not match regular expression
+    int nLen2 = strlen(pSourceFieldDef->szFormat);
+    if (nLen2 > MAX_FORMAT_ERROR_LEN) {
+      nLen2 = MAX_FORMAT_ERROR_LEN;
+      mystrncpy(szShortFormat, pSourceFieldDef->szFormat, nLen2 + 1);
+      strcpy(szShortFormat + nLen2, " ...");
+    }
+    else
+      strcpy(szShortFormat, pSourceFieldDef->szFormat);
 
-  if (!pPos) {
-    sprintf(szLastError, "No compare operator found (' < ',' > ',' = ',' != ')");
-    pszLastErrorPos = pszCondition;
-    return 1;
+    if (*szShortFormat == ',') {
+      *szShortFormat = '(';
+      nLen2 = strlen(szShortFormat);
+      if (nLen2 > 2 && szShortFormat[nLen2-1] == ',')
+        szShortFormat[nLen2-1] = ')';
+      sprintf(szLastFieldMappingError, "Value not found in list %s", szShortFormat);
+    }
+    else
+      sprintf(szLastFieldMappingError, "Invalid characters found (does not match %s)", szShortFormat);
+
+    return 3;
   }
 
-  // operator found
-  pSimpleCondition->szLeftPart = pszCondition;
-  *pPos++ = '\0';
-  pSimpleCondition->szOperator = pPos;
-  pPos += strlen(szOperator) - 2;
-  *pPos++ = '\0';
-  pSimpleCondition->szRightPart = pPos;
+  // source value is valid
+  if (*pSourceFieldDef->szFormat == ',' && *pDestFieldDef->szFormat == ',' && strcmp(pSourceFieldDef->szFormat, pDestFieldDef->szFormat) != 0) {
+    // source and destination format contain list of valid strings --> map content
+    cpchar pszSourceFormat = pSourceFieldDef->szFormat + 1;
+    cpchar pszDestFormat = pDestFieldDef->szFormat + 1;
+    cpchar pszTemp = NULL;
+    bool bFound = false;
+    int nItem = -1;
+
+    // compiled enumerations: destination value with same index as source value
+    if (pSourceFieldDef->Format.cKind == 'E' && pDestFieldDef->Format.cKind == 'E' && !strchr(pszSourceValue, ','))
+      nItem = FindEnumerationItem(&pSourceFieldDef->Format, pszSourceValue, nLen);
+    if (nItem >= 0 && nItem < pDestFieldDef->Format.nItems) {
+      EnumerationItem const *pDestItem = pDestFieldDef->Format.aItem + nItem;
+      memcpy(pszDestValue, pDestItem->pszValue, pDestItem->nLen);
+      pszDestValue[pDestItem->nLen] = '\0';
+      bFound = true;
+    }
 
-  len = strlen(pPos);
-  if (*pPos == '\'' && len >= 2) {
-    // fill szCurrentValue with unquoted right part of condition (string content)
-    pSimpleCondition->szCurrentValue = (pchar)MyGetMemory(len-1);
-    if (pSimpleCondition->szCurrentValue)
-      mystrncpy(pSimpleCondition->szCurrentValue, pPos + 1, len-1);
+    while (!bFound && *pszSourceFormat && *pszDestFormat) {
+      if (strncmp(pszSourceFormat, pszSourceValue, nLen) == 0 /*&& strlen(pszSourceFormat) > nLen*/ && pszSourceFormat[nLen] == ',') {
+        CopyStringTill(pszDestValue, pszDestFormat, ',');
+        bFound = true;
+      }
+      else {
+        // goto next string in list of source format
+        pszTemp = strchr(pszSourceFormat, ',');
+        pszSourceFormat = pszTemp ? pszTemp+1 : strchr(pszSourceFormat, '\0');
+        // goto next string in list of destination format
+        pszTemp = strchr(pszDestFormat, ',');
+        pszDestFormat = pszTemp ? pszTemp+1 : strchr(pszDestFormat, '\0');
+      }
+    }
   }
-  else
-    pSimpleCondition->szCurrentValue = NULL;
+  else {
+    if (*pDestFieldDef->szMappingFormat) {
+      nAddLen = strlen(pDestFieldDef->szMappingFormat) - 3;
+      if (nLen + nAddLen > nMaxLen)
+        return -1;  // destination value buffer is too small
 
-  return 0;
+      if (*pDestFieldDef->szMappingFormat == '\'') {
+        // Sample: "'PRAEFIX-'*"
+        strcpy(pszDestValue, pDestFieldDef->szMappingFormat + 1);
+        strcpy(pszDestValue + nAddLen, pszSourceValue);
+      }
+      else {
+        // Sample: "*'-POSTFIX'"
+        strcpy(pszDestValue, pszSourceValue);
+        mystrncpy(pszDestValue + nLen, pDestFieldDef->szMappingFormat + 2, nAddLen);
+      }
+    }
+    else {
+      // no enumeration, so copy source value simply to destination buffer
+      strcpy(pszDestValue, pszSourceValue);
+    }
+  }
+
+  return nErrorCode;
 }
-// end of function "ParseSimpleCondition"
+// end of function "MapTextFormat"
 
 //--------------------------------------------------------------------------------------------------------
 
-PComplexCondition GetNewComplexCondition()
+int MapBoolFormat(cpchar pszSourceValue, CPFieldDefinition pSourceFieldDef, pchar pszDestValue, CPFieldDefinition pDestFieldDef)
 {
-  PComplexCondition pComplexCondition = (PComplexCondition)MyGetMemory(sizeof(ComplexCondition));
+  cpchar pszSourceFormat = pSourceFieldDef->szFormat;
+  cpchar pszDestFormat = pDestFieldDef->szFormat;
+  FormatMatcher const *pSourceMatcher = &pSourceFieldDef->Format;
+  cpchar pPos = NULL;
+  char szShortFormat[MAX_FORMAT_ERROR_SIZE+4];
 
-  if (pComplexCondition) {
-    pComplexCondition->LeftCondition.pComplexCondition = NULL;
-    pComplexCondition->LeftCondition.pSimpleCondition = NULL;
-    pComplexCondition->op = NO_OP;
-    pComplexCondition->RightCondition.pComplexCondition = NULL;
-    pComplexCondition->RightCondition.pSimpleCondition = NULL;
+  if (!pszSourceFormat || !*pszSourceFormat) {
+    pszSourceFormat = szDefaultBooleanFormat;
+    pSourceMatcher = &DefaultBooleanMatcher;
   }
 
-  return pComplexCondition;
+  if (!pszDestFormat || !*pszDestFormat)
+    pszDestFormat = szDefaultBooleanFormat;
+
+  *szLastFieldMappingError = '\0';
+
+  if (!*pszSourceValue && !pSourceFieldDef->bMandatory)
+    return 0;  // empty value is allowed for optional fields
+
+  if (!MatchFormat(pszSourceValue, pSourceMatcher, pszSourceFormat)) {
+    int nLen = strlen(pSourceFieldDef->szFormat);
+    if (nLen > MAX_FORMAT_ERROR_LEN) {
+      nLen = MAX_FORMAT_ERROR_LEN;
+      mystrncpy(szShortFormat, pSourceFieldDef->szFormat, nLen + 1);
+      strcpy(szShortFormat + nLen, " ...");
+    }
+    else
+      strcpy(szShortFormat, pSourceFieldDef->szFormat);
+
+    *szShortFormat = '(';
+    nLen = strlen(szShortFormat);
+    if (nLen > 2 && szShortFormat[nLen-1] == ',')
+      szShortFormat[nLen-1] = ')';
+    sprintf(szLastFieldMappingError, "Value not found in list %s", szShortFormat);
+    return 3;
+  }
+
+  // source value is valid
+  pPos = strchr(pszDestFormat+1, ',');
+  if (!pPos) {
+    sprintf(szLastFieldMappingError, "Second string missing in destination format %s", pszDestFormat);
+    return 4;
+  }
+
+  // source value matching first or second string defined in source format ?
+  if (strncmp(pszSourceValue, pszSourceFormat + 1, strlen(pszSourceValue)) == 0)
+    CopyStringTill(pszDestValue, pszDestFormat + 1, ',');  // copy first string defined in destination format (e.g. "true")
+  else
+    CopyStringTill(pszDestValue, pPos + 1, ',');  // copy second string defined in destination format (e.g. "false")
+
+  return 0;  // success
 }
+// end of function "MapBoolFormat"
 
 //--------------------------------------------------------------------------------------------------------
 
-int ParseCondition(pchar pszCondition, PCondition pCondition, pchar *ppNext = NULL)
+void CompileBooleanLookup(BooleanLookup *pLookup, CPFieldDefinition pSourceFieldDef, CPFieldDefinition pDestFieldDef)
 {
-  // Parses conditions like "CCY != FUND_CCY" or "48_* = '1'" (mandatory space before and after operator !)
-  //   or like "((@fromCcy = xpath1) and (@toCcy = xpath2) and (@mulDiv = 'D')) or ((@fromCcy = xpath3) and (@toCcy = xpath4) and (@mulDiv = 'M'))"
-  //   or like "((@fromCcy = Funds/Fund/FundDynamicData/Portfolios/Portfolio/Positions/Position/Currency) and (@toCcy = Funds/Fund/Currency) and (@mulDiv = 'D')) or ((@fromCcy = Funds/Fund/Currency) and (@toCcy = Funds/Fund/FundDynamicData/Portfolios/Portfolio/Positions/Position/Currency) and (@mulDiv = 'M'))"
-  // Supported operators: "=", "!=", "<", ">"
-  //
-  pchar pPos = pszCondition;
-  pchar pOpeningBracket = NULL;
-  pchar pClosingBracket = NULL;
-  PComplexCondition pComplexCondition = NULL;
-  PComplexCondition pComplexSubCondition = NULL;
-  int nReturnCode, nLen;
-  bool bEnclosingBrackets = false;
+  // same result as MapBoolFormat for source formats with exactly two strings, e.g. "(J,N)" --> "(true,false)"
+  cpchar pszSourceFormat = pSourceFieldDef->szFormat;
+  cpchar pszDestFormat = pDestFieldDef->szFormat;
+  cpchar pPos;
+  int i;
 
-  pCondition->pComplexCondition = NULL;
-  pCondition->pSimpleCondition = NULL;
+  pLookup->bCompiled = false;
 
-  /*if (*pPos) {
-    pOpeningBracket = strchr(pPos+1, '(');
-    pClosingBracket = strchr(pPos+1, ')');
-    if (pClosingBracket < pOpeningBracket)
-      pOpeningBracket = NULL;  // opening bracket behind closing bracket
-  }*/
+  if (!pszSourceFormat || !*pszSourceFormat)
+    pszSourceFormat = szDefaultBooleanFormat;
+  else
+  if (pSourceFieldDef->Format.cKind != 'E')
+    return;
 
-  if (*pPos == '(' /*&& pOpeningBracket*/) {
-    // complex condition with logical operator
+  if (!pszDestFormat || !*pszDestFormat)
+    pszDestFormat = szDefaultBooleanFormat;
+
+  // source format ",first,second,"
+  if (*pszSourceFormat != ',')
+    return;
+  pPos = pszSourceFormat + 1;
+  for (i = 0; i < 2; i++) {
+    pLookup->aSource[i].pszValue = pPos;
+    while (*pPos && *pPos != ',')
+      pPos++;
+    pLookup->aSource[i].nLen = (int)(pPos - pLookup->aSource[i].pszValue);
+    if (*pPos != ',' || pLookup->aSource[i].nLen == 0)
+      return;
     pPos++;
-    pCondition->pComplexCondition = pComplexCondition = GetNewComplexCondition();
+  }
+  if (*pPos)
+    return;  // more than two strings
 
-    nReturnCode = ParseCondition(pPos, &pComplexCondition->LeftCondition, &pPos);
-    if (nReturnCode != 0)
-      return nReturnCode;
+  // destination format: first and second string (missing second string is reported by MapBoolFormat)
+  pPos = pszDestFormat + 1;
+  for (i = 0; i < 2; i++) {
+    pLookup->aDest[i].pszValue = pPos;
+    while (*pPos && *pPos != ',')
+      pPos++;
+    pLookup->aDest[i].nLen = (int)(pPos - pLookup->aDest[i].pszValue);
+    if (i == 0 && *pPos != ',')
+      return;
+    pPos++;
+  }
 
-    while (*pPos == ' ')
-      pPos++;  // skip spaces
+  // MapBoolFormat maps every source value being the beginning of the first string to the first destination string
+  if (pLookup->aSource[1].nLen <= pLookup->aSource[0].nLen && memcmp(pLookup->aSource[1].pszValue, pLookup->aSource[0].pszValue, pLookup->aSource[1].nLen) == 0)
+    pLookup->aDest[1] = pLookup->aDest[0];
 
-    if (strnicmp(pPos, "and", 3) == 0) {
-      pComplexCondition->op = AND_OP;
-      pPos += 3;
-    }
-    else
-      if (strnicmp(pPos, "or", 2) == 0) {
-        pComplexCondition->op = OR_OP;
-        pPos += 2;
-      }
-      else {
-        sprintf(szLastError, "Missing logical operator ('and'/'or')");
-        pszLastErrorPos = pPos;
-        return 1;
-      }
+  pLookup->bCompiled = true;
+}
 
-    while (*pPos == ' ')
-      pPos++;  // skip spaces
+//--------------------------------------------------------------------------------------------------------
 
-    if (*pPos == '(')
-      pPos++;
-    else {
-      sprintf(szLastError, "Opening bracket '(' expected behind logical operator");
-      pszLastErrorPos = pPos;
-      return 3;
+int LookupBooleanValue(BooleanLookup const *pLookup, cpchar pszSourceValue, pchar pszDestValue, int nMaxLen)
+{
+  // map source value with compiled boolean format (-1 = not compiled or not found, use MapBoolFormat)
+  int i, nLen;
+
+  if (!pLookup->bCompiled || !*pszSourceValue)
+    return -1;
+
+  for (i = 0; i < 2; i++) {
+    EnumerationItem const *pSource = pLookup->aSource + i;
+    if (*pszSourceValue == *pSource->pszValue && strncmp(pszSourceValue, pSource->pszValue, pSource->nLen) == 0 && pszSourceValue[pSource->nLen] == '\0') {
+      nLen = pLookup->aDest[i].nLen;
+      if (nLen > nMaxLen)
+        return -1;
+      memcpy(pszDestValue, pLookup->aDest[i].pszValue, nLen);
+      pszDestValue[nLen] = '\0';
+      *szLastFieldMappingError = '\0';
+      return 0;
     }
+  }
 
-    nReturnCode = ParseCondition(pPos, &pComplexCondition->RightCondition, &pPos);
-    if (nReturnCode != 0)
-      return nReturnCode;
+  return -1;
+}
 
-    while (*pPos == ' ')
-      pPos++;  // skip spaces
+//--------------------------------------------------------------------------------------------------------
 
-    // more logical operators ?
+bool ConvertNumber(cpchar szValue, char cType, int *pnValue, double *pfValue)
+{
+  DecimalNumber Number;
+  long long nValue = 0;
+  bool bOK = FALSE;
 
-    while (strnicmp(pPos, "and", 3) == 0 || strnicmp(pPos, "or", 2) == 0) {
-      // add complex condition
-      pComplexSubCondition = GetNewComplexCondition();
-      // move old right condition to left condition of new complex condition (adding one level to condition tree)
-      pComplexSubCondition->LeftCondition = pComplexCondition->RightCondition;
-      pComplexCondition->RightCondition.pComplexCondition = pComplexSubCondition;
-      pComplexCondition->RightCondition.pSimpleCondition = NULL;
+  *szLastError = '\0';
 
-      if (strnicmp(pPos, "and", 3) == 0) {
-        pComplexSubCondition->op = AND_OP;
-        nLen = 3;
-      }
-      else {
-        pComplexSubCondition->op = OR_OP;
-        nLen = 2;
-      }
+  if (cType == 'I'/*INTEGER*/) {
+    if (strpbrk(szValue, "0123456789") && ScanNumber(szValue, '\0', " ", NULL, '\0', &Number) == NUMBER_VALID && Number.nDigits <= 10) {
+      for (int i = 0; i < Number.nDigits; i++)
+        nValue = 10 * nValue + (Number.acDigits[i] - '0');
+      if (Number.bNegative)
+        nValue = -nValue;
+      bOK = (nValue >= INT_MIN && nValue <= INT_MAX);
+    }
+    if (bOK)
+      *pnValue = (int)nValue;
+    else
+      strcpy(szLastError, "Invalid integer value");
+  }
 
-      if (pComplexCondition->op != pComplexSubCondition->op) {
-        sprintf(szLastError, "Logical operators (and/or) cannot be mixed on same level");
-        pszLastErrorPos = pPos;
-        return 2;
-      }
+  if (cType == 'N'/*NUMBER*/) {
+    if (strpbrk(szValue, "0123456789") && ScanNumber(szValue, cDecimalPoint, " ", NULL, '\0', &Number) == NUMBER_VALID) {
+      *pfValue = GetDecimalNumberValue(&Number);
+      bOK = TRUE;
+    }
+    else
+      strcpy(szLastError, "Invalid number value");
+  }
 
-      pPos += nLen;  // go to end of operator (and/or)
+  return bOK;
+}
+// end of function "ConvertNumber"
+//--------------------------------------------------------------------------------------------------------
 
-      while (*pPos == ' ')
-        pPos++;  // skip spaces
+int GetDaysFromDate(int nYear, int nMonth, int nDay)
+{
+  // get number of days since 01.01.1970 (proleptic gregorian calendar)
+  nYear -= (nMonth <= 2);
+  int nEra = (nYear >= 0 ? nYear : nYear - 399) / 400;
+  int nYearOfEra = nYear - nEra * 400;
+  int nDayOfYear = (153 * (nMonth + (nMonth > 2 ? -3 : 9)) + 2) / 5 + nDay - 1;
+  int nDayOfEra = nYearOfEra * 365 + nYearOfEra / 4 - nYearOfEra / 100 + nDayOfYear;
+
+  return nEra * 146097 + nDayOfEra - 719468;
+}
 
-      if (*pPos == '(')
-        pPos++;
-      else {
-        sprintf(szLastError, "Opening bracket '(' expected behind logical operator");
-        pszLastErrorPos = pPos;
-        return 3;
-      }
+//--------------------------------------------------------------------------------------------------------
 
-      nReturnCode = ParseCondition(pPos, &pComplexSubCondition->RightCondition, &pPos);
-      if (nReturnCode != 0)
-        return nReturnCode;
+void GetDateFromDays(int nDays, int *pnYear, int *pnMonth, int *pnDay)
+{
+  // get date from number of days since 01.01.1970 (proleptic gregorian calendar)
+  nDays += 719468;
+  int nEra = (nDays >= 0 ? nDays : nDays - 146096) / 146097;
+  int nDayOfEra = nDays - nEra * 146097;
+  int nYearOfEra = (nDayOfEra - nDayOfEra / 1460 + nDayOfEra / 36524 - nDayOfEra / 146096) / 365;
+  int nDayOfYear = nDayOfEra - (365 * nYearOfEra + nYearOfEra / 4 - nYearOfEra / 100);
+  int nMonthIndex = (5 * nDayOfYear + 2) / 153;
+
+  *pnDay = nDayOfYear - (153 * nMonthIndex + 2) / 5 + 1;
+  *pnMonth = (nMonthIndex < 10) ? nMonthIndex + 3 : nMonthIndex - 9;
+  *pnYear = nYearOfEra + nEra * 400 + (*pnMonth <= 2);
+}
 
-      pComplexCondition = pComplexSubCondition;
+//--------------------------------------------------------------------------------------------------------
 
-      while (*pPos == ' ')
-        pPos++;  // skip spaces
-    }
+int GetDaysOfMonth(int nYear, int nMonth)
+{
+  static const int anDaysOfMonth[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
 
-    if (*pPos == ')')
-      pPos++;
-    else {
-      sprintf(szLastError, "Closing bracket ')' or logical operator ('and'/'or') expected");
-      pszLastErrorPos = pPos;
-      return 3;
-    }
-  }
-  else {
-    // simple condition
-    /*if (*pPos == '(') {
-      bEnclosingBrackets = true;
-      pPos++;
-    }*/
+  if (nMonth == 2 && ((nYear % 4 == 0 && nYear % 100 != 0) || nYear % 400 == 0))
+    return 29;
 
-    pClosingBracket = strchr(pPos, ')');
-    if (pClosingBracket)
-      *pClosingBracket = '\0';
+  return anDaysOfMonth[nMonth - 1];
+}
 
-    pCondition->pSimpleCondition = (PSimpleCondition)MyGetMemory(sizeof(SimpleCondition));
+//--------------------------------------------------------------------------------------------------------
 
-    nReturnCode = ParseSimpleCondition(pPos, pCondition->pSimpleCondition);
-    if (nReturnCode != 0)
-      return nReturnCode;
+int DecodeTypedInteger(cpchar pszValue, TypedValue *pTypedValue)
+{
+  // decode integer value (same syntax as accepted by MapIntFormat: spaces are ignored, optional sign)
+  cpchar pPos = pszValue;
+  long long nValue = 0;
+  int nDigits = 0;
+  bool bNegative = false, bDigitFound = false;
 
-    if (pClosingBracket)
-      pPos = pClosingBracket + 1;
-    else
-      pPos = strchr(pPos, '\0');
+  pTypedValue->nValue = 0;
+  pTypedValue->nExtra = 0;
+  pTypedValue->nErrorCode = TYPED_VALID;
+
+  if (!*pPos)
+    return pTypedValue->nErrorCode = TYPED_EMPTY;
+
+  if (*pPos == '+')
+    pPos++;  // ignore plus sign at the start
+
+  while (*pPos == ' ')
+    pPos++;
+
+  if (*pPos == '-') {
+    bNegative = true;
+    pPos++;
   }
 
-  if (ppNext)
-    *ppNext = pPos;
+  for (; *pPos; pPos++) {
+    if (*pPos == ' ')
+      continue;
+    if (*pPos < '0' || *pPos > '9')
+      return pTypedValue->nErrorCode = TYPED_SYNTAX_ERROR;
+    bDigitFound = true;
+    nDigits++;  // longer values are left to the string functions (same error messages)
+    if (nDigits > 18)
+      return pTypedValue->nErrorCode = TYPED_OVERFLOW;
+    nValue = 10 * nValue + (*pPos - '0');
+  }
 
-  return 0;
+  if (!bDigitFound)
+    return pTypedValue->nErrorCode = TYPED_SYNTAX_ERROR;
+
+  pTypedValue->nValue = bNegative ? -nValue : nValue;
+
+  return TYPED_VALID;
 }
-// end of function "ParseCondition"
 
 //--------------------------------------------------------------------------------------------------------
 
-void SimpleAddAttributeToList(AttributeNameValueList *pAttrNameValueList, cpchar pszAttrName, cpchar pszAttrValue)
+int DecodeTypedNumber(cpchar pszValue, char cSourceDecimalPoint, TypedValue *pTypedValue)
 {
-  if (pAttrNameValueList->nCount >= pAttrNameValueList->nMaxCount)
-    return;  // error
+  // decode number to mantissa and number of fraction digits
+  // (same syntax as accepted by MapNumberFormat: spaces and 1000-delimiters are ignored, optional sign)
+  cpchar pPos = pszValue;
+  char cThousandsDelimiter = (cSourceDecimalPoint == '.') ? ',' : '.';
+  long long nValue = 0;
+  int nDigits = 0, nScale = 0;
+  bool bNegative = false, bDigitFound = false, bFraction = false;
 
-  AttributeNameValue *pAttrNameValue = pAttrNameValueList->aAttrNameValue + pAttrNameValueList->nCount;
-  mystrncpy(pAttrNameValue->szName, pszAttrName, MAX_ATTR_NAME_SIZE);
-  mystrncpy(pAttrNameValue->szValue, pszAttrValue, MAX_ATTR_VALUE_SIZE);
-  pAttrNameValue->pszXPath = NULL;
-  pAttrNameValueList->nCount++;
-}
+  pTypedValue->nValue = 0;
+  pTypedValue->nExtra = 0;
+  pTypedValue->nErrorCode = TYPED_VALID;
 
-//--------------------------------------------------------------------------------------------------------
+  if (!*pPos)
+    return pTypedValue->nErrorCode = TYPED_EMPTY;
 
-void AddAttributeToList(AttributeNameValueList *pAttrNameValueList, PCondition pCondition)
-{
-  if (pCondition->pComplexCondition) {
-    AddAttributeToList(pAttrNameValueList, &pCondition->pComplexCondition->LeftCondition);
-    if (pCondition->pComplexCondition->op == AND_OP)
-      AddAttributeToList(pAttrNameValueList, &pCondition->pComplexCondition->RightCondition);
-  }
-  
-  if (pCondition->pSimpleCondition && *pCondition->pSimpleCondition->szLeftPart == '@' && strcmp(pCondition->pSimpleCondition->szOperator, "=") == 0) {
-    if (pAttrNameValueList->nCount >= pAttrNameValueList->nMaxCount)
-      return;  // error
+  if (*pPos == '+')
+    pPos++;  // ignore plus sign at the start
 
-    mystrncpy(pAttrNameValueList->aAttrNameValue[pAttrNameValueList->nCount].szName, pCondition->pSimpleCondition->szLeftPart + 1, MAX_ATTR_NAME_SIZE);
+  while (*pPos == ' ' || *pPos == cThousandsDelimiter)
+    pPos++;
 
-    if (*pCondition->pSimpleCondition->szRightPart == '\'') {
-      mystrncpy(pAttrNameValueList->aAttrNameValue[pAttrNameValueList->nCount].szValue, pCondition->pSimpleCondition->szRightPart + 1, MAX_ATTR_VALUE_SIZE);
-      RemoveLastChar(pAttrNameValueList->aAttrNameValue[pAttrNameValueList->nCount].szValue, '\'');
-      pAttrNameValueList->aAttrNameValue[pAttrNameValueList->nCount].pszXPath = NULL;
-    }
-    else {
-      strcpy(pAttrNameValueList->aAttrNameValue[pAttrNameValueList->nCount].szValue, szEmptyString);
-      pAttrNameValueList->aAttrNameValue[pAttrNameValueList->nCount].pszXPath = pCondition->pSimpleCondition->szRightPart;
-    }
+  if (*pPos == '-') {
+    bNegative = true;
+    pPos++;
+  }
 
-    pAttrNameValueList->nCount++;
+  for (; *pPos; pPos++) {
+    if (*pPos == ' ' || *pPos == cThousandsDelimiter)
+      continue;
+    if (*pPos == cSourceDecimalPoint && !bFraction) {
+      bFraction = true;
+      continue;
+    }
+    if (*pPos < '0' || *pPos > '9')
+      return pTypedValue->nErrorCode = TYPED_SYNTAX_ERROR;
+    bDigitFound = true;
+    nDigits++;  // longer values are left to the string functions (same error messages)
+    if (bFraction)
+      nScale++;
+    if (nDigits > 18 || nScale > 18)
+      return pTypedValue->nErrorCode = TYPED_OVERFLOW;
+    nValue = 10 * nValue + (*pPos - '0');
   }
-}
 
-//--------------------------------------------------------------------------------------------------------
+  if (!bDigitFound)
+    return pTypedValue->nErrorCode = TYPED_SYNTAX_ERROR;
 
-void GetAttributeList(AttributeNameValueList *pAttrNameValueList, PCondition pCondition)
-{
-  // Parses conditions like "CCY != FUND_CCY" or "48_* = '1'" (mandatory space before and after operator !)
-  //   or like "((@fromCcy = Funds/Fund/FundDynamicData/Portfolios/Portfolio/Positions/Position/Currency) and (@toCcy = Funds/Fund/Currency) and (@mulDiv = 'D')) or ((@fromCcy = Funds/Fund/Currency) and (@toCcy = Funds/Fund/FundDynamicData/Portfolios/Portfolio/Positions/Position/Currency) and (@mulDiv = 'M'))" ?
+  pTypedValue->nValue = bNegative ? -nValue : nValue;
+  pTypedValue->nExtra = nScale;
 
-  pAttrNameValueList->nCount = 0;
-  AddAttributeToList(pAttrNameValueList, pCondition);
+  return TYPED_VALID;
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-typedef struct {
-  pchar *aField;
-  int nFields;
-  int nMapIndex;
-  FieldMapping *pFieldMapping;
-  FieldDefinition *pFieldDefinition;
-} FieldMappingContext;
+int DecodeTypedDate(cpchar pszValue, DateCodec const *pCodec, TypedValue *pTypedValue)
+{
+  // decode date (and time) to days since 01.01.1970 and seconds since midnight
+  // (strict version of MapDateFormat: only digits allowed and calendar date must exist)
+  int i, anValue[DATE_COMPONENTS];
 
-//--------------------------------------------------------------------------------------------------------
+  pTypedValue->nValue = 0;
+  pTypedValue->nExtra = 0;
+  pTypedValue->nErrorCode = TYPED_VALID;
 
-pchar LoadTextMappingField(FieldMappingContext const *pContext, cpchar pszFieldName, int nFieldIndex, /*bool bMandatory,*/ cpchar pszValidContent)
-{
-  pchar pszResult = (pchar)szEmptyString;
+  if (!*pszValue)
+    return pTypedValue->nErrorCode = TYPED_EMPTY;
 
-  if (nFieldIndex >= 0 && nFieldIndex < pContext->nFields) {
-    pszResult = pContext->aField[nFieldIndex];
+  if ((int)strlen(pszValue) != pCodec->nLen)
+    return pTypedValue->nErrorCode = TYPED_SYNTAX_ERROR;
 
-    // check content
-    if ((!IsEmptyString(pszValidContent) /*|| bMandatory*/) && !CheckRegex(pszResult, pszValidContent)) {
-      sprintf(szLastError, "Invalid content '%s' (not in '%s')", pszResult, pszValidContent+1);
-      LogMappingError(pContext->nMapIndex, GetOperationLongName(pContext->pFieldDefinition->cOperation), pszFieldName, szLastError);
-      pszResult = (pchar)szEmptyString;
-    }
-    else {
-      int nLen = strlen(pszResult);
-      if ((strcmp(pszFieldName, "CSV_FORMAT") == 0 || strcmp(pszFieldName, "XML_FORMAT") == 0) && nLen >= 3 && *pszResult == '(' && pszResult[nLen-1] == ')') {
-        // change first and last character to comma for easier check of content (comma+text+comma must be part of this string)
-        *pszResult = ',';
-        pszResult[nLen-1] = ',';
-      }
-    }
-  }
+  // digits at positions of date components, delimiters at all other positions
+  for (i = 0; i < pCodec->nLen; i++)
+    if (strchr("DMYhms", pCodec->pszFormat[i]) ? (pszValue[i] < '0' || pszValue[i] > '9') : (pszValue[i] != pCodec->pszFormat[i]))
+      return pTypedValue->nErrorCode = TYPED_SYNTAX_ERROR;
 
-  return pszResult;
+  if (DecodeDate(pszValue, pCodec, anValue) != 0)
+    return pTypedValue->nErrorCode = TYPED_CALENDAR_ERROR;
+
+  pTypedValue->nValue = GetDaysFromDate(anValue[DATE_YEAR], anValue[DATE_MONTH], anValue[DATE_DAY]);
+  pTypedValue->nExtra = 3600 * anValue[DATE_HOUR] + 60 * anValue[DATE_MINUTE] + anValue[DATE_SECOND];
+
+  return TYPED_VALID;
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-bool LoadBoolMappingField(FieldMappingContext const *pContext, cpchar pszFieldName, int nFieldIndex, cpchar pszTrue, cpchar pszFalse, bool bDefault)
+int FormatTypedValue(TypedValue const *pTypedValue, char cType, DateCodec const *pDestCodec, pchar pszDestValue, int nMaxLen)
 {
-  bool bResult = bDefault;
-  pchar pszContent = NULL;
+  // write decoded value in xml format (integer and number without leading zeros, number with decimal point '.')
+  char szDigits[32];
+  int anValue[DATE_COMPONENTS], nLen, nScale;
+  long long nValue = pTypedValue->nValue;
+  pchar pDest = pszDestValue;
 
-  if (nFieldIndex >= 0 && nFieldIndex < pContext->nFields) {
-    pszContent = pContext->aField[nFieldIndex];
-    if (!IsEmptyString(pszContent)) {
-      if (strnicmp(pszContent, pszTrue, strlen(pszTrue)) == 0)
-        bResult = true;
-      else
-        if (strnicmp(pszContent, pszFalse, strlen(pszFalse)) == 0)
-          bResult = false;
-        else {
-          sprintf(szLastError, "Invalid content '%s' (not in '%s,%s')", pszContent, pszTrue, pszFalse);
-          LogMappingError(pContext->nMapIndex, GetOperationLongName(pContext->pFieldDefinition->cOperation), pszFieldName, szLastError);
-        }
+  if (cType == 'I'/*INTEGER*/) {
+    sprintf(szDigits, "%lld", nValue);
+    if ((int)strlen(szDigits) > nMaxLen)
+      return -1;  // destination value buffer is too small
+    strcpy(pszDestValue, szDigits);
+    return 0;
+  }
+
+  if (cType == 'N'/*NUMBER*/) {
+    // digits of mantissa with minimum one digit before decimal point
+    nScale = pTypedValue->nExtra;
+    if (nScale < 0 || nScale > 18)
+      return -1;  // not decoded by DecodeTypedNumber (maximum 18 digits)
+    sprintf(szDigits, "%0*lld", nScale + 1, (nValue < 0) ? -nValue : nValue);
+    nLen = strlen(szDigits);
+    if (nLen + 2 > nMaxLen)
+      return -1;  // destination value buffer is too small
+    if (nValue < 0)
+      *pDest++ = '-';
+    memcpy(pDest, szDigits, nLen - nScale);
+    pDest += nLen - nScale;
+    if (nScale > 0) {
+      *pDest++ = '.';
+      memcpy(pDest, szDigits + nLen - nScale, nScale);
+      pDest += nScale;
     }
+    *pDest = '\0';
+    return 0;
   }
 
-  return bResult;
+  if (cType == 'D'/*DATE*/) {
+    if (pDestCodec->nLen > nMaxLen)
+      return -1;  // destination value buffer is too small
+    GetDateFromDays((int)nValue, anValue + DATE_YEAR, anValue + DATE_MONTH, anValue + DATE_DAY);
+    anValue[DATE_HOUR] = pTypedValue->nExtra / 3600;
+    anValue[DATE_MINUTE] = pTypedValue->nExtra / 60 % 60;
+    anValue[DATE_SECOND] = pTypedValue->nExtra % 60;
+    EncodeDate(pDestCodec, pszDestValue, anValue);
+    return 0;
+  }
+
+  return -1;
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-char LoadCharMappingField(FieldMappingContext const *pContext, cpchar pszFieldName, int nFieldIndex, bool bMandatory, cpchar pszValidContent, char cDefault)
+int CompareWithRangeLimit(TypedValue const *pTypedValue, char cType, RangeLimit const *pLimit)
 {
-  char cResult = cDefault;
-  pchar pszContent = NULL;
-  bool bOK;
+  // compare decoded value with decoded limit (-1 = below, 0 = equal, 1 = above)
+  static const long long anPowerOfTen[19] = { 1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL, 1000000000LL,
+    10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL, 100000000000000LL, 1000000000000000LL,
+    10000000000000000LL, 100000000000000000LL, 1000000000000000000LL };
+  long long nValue = pTypedValue->nValue, nLimit = pLimit->nValue;
+  int nScale;
+  DecimalNumber Number;
 
-  if (nFieldIndex >= 0 && nFieldIndex < pContext->nFields) {
-    // check content
-    pszContent = pContext->aField[nFieldIndex];
-    bOK = IsEmptyString(pszContent) ? !bMandatory : CheckRegex(pszContent, pszValidContent);
-    if (bOK)
-      cResult = toupper(*pszContent);
-    else {
-      sprintf(szLastError, "Invalid content '%s' (not in '%s')", pszContent, pszValidContent+1);
-      LogMappingError(pContext->nMapIndex, GetOperationLongName(pContext->pFieldDefinition->cOperation), pszFieldName, szLastError);
+  if (cType == 'N'/*NUMBER*/) {
+    if (!pLimit->bBinary || pTypedValue->nExtra > 18 || pLimit->nExtra > 18) {
+      GetScaledDecimalNumber(nValue, pTypedValue->nExtra, &Number);
+      return CompareDecimalNumbers(&Number, &pLimit->Number);
+    }
+
+    // same number of fraction digits (a mantissa out of range after scaling is beyond every other mantissa)
+    nScale = pLimit->nExtra - pTypedValue->nExtra;
+    if (nScale > 0) {
+      if (nValue > LLONG_MAX / anPowerOfTen[nScale] || nValue < -(LLONG_MAX / anPowerOfTen[nScale]))
+        return (nValue < 0) ? -1 : 1;
+      nValue *= anPowerOfTen[nScale];
+    }
+    if (nScale < 0) {
+      if (nLimit > LLONG_MAX / anPowerOfTen[-nScale] || nLimit < -(LLONG_MAX / anPowerOfTen[-nScale]))
+        return (nLimit < 0) ? 1 : -1;
+      nLimit *= anPowerOfTen[-nScale];
     }
   }
 
-  return cResult;
+  if (nValue != nLimit)
+    return (nValue < nLimit) ? -1 : 1;
+
+  // date: same day, compare time
+  if (cType == 'D'/*DATE*/ && pTypedValue->nExtra != pLimit->nExtra)
+    return (pTypedValue->nExtra < pLimit->nExtra) ? -1 : 1;
+
+  return 0;
 }
+// end of function "CompareWithRangeLimit"
 
 //--------------------------------------------------------------------------------------------------------
 
-int LoadIntMappingField(FieldMappingContext const *pContext, cpchar pszFieldName, int nFieldIndex, int nDefault)
+int CheckTypedMinMaxValues(TypedValue const *pTypedValue, CPFieldDefinition pFieldDefinition)
 {
-  int nResult = nDefault;
-  pchar pszContent = NULL;
+  // same checks as CheckMinMaxValues and CheckDateLimits based on decoded value
+  char cType = pFieldDefinition->cType;
 
-  if (nFieldIndex >= 0 && nFieldIndex < pContext->nFields) {
-    pszContent = pContext->aField[nFieldIndex];
-    // TODO: check content
-    if (*pszContent >= '0' && *pszContent <= '9')
-      nResult = atoi(pszContent);
+  if (!pFieldDefinition->pMinLimit && !pFieldDefinition->pMaxLimit)
+    return 0;
+
+  if (pFieldDefinition->pMinLimit && CompareWithRangeLimit(pTypedValue, cType, pFieldDefinition->pMinLimit) < 0) {
+    if (cType == 'I'/*INTEGER*/)
+      sprintf(szLastFieldMappingError, "Integer value below limit %d", pFieldDefinition->nMinValue);
+    else
+    if (cType == 'N'/*NUMBER*/)
+      sprintf(szLastFieldMappingError, "Number value below limit %lf", pFieldDefinition->fMinValue);
+    else
+      sprintf(szLastFieldMappingError, "Date value below limit %s", pFieldDefinition->szMinValue);
+    return 4;
   }
 
-  return nResult;
+  if (pFieldDefinition->pMaxLimit && CompareWithRangeLimit(pTypedValue, cType, pFieldDefinition->pMaxLimit) > 0) {
+    if (cType == 'I'/*INTEGER*/)
+      sprintf(szLastFieldMappingError, "Integer value above limit %d", pFieldDefinition->nMaxValue);
+    else
+    if (cType == 'N'/*NUMBER*/)
+      sprintf(szLastFieldMappingError, "Number value above limit %lf", pFieldDefinition->fMaxValue);
+    else
+      sprintf(szLastFieldMappingError, "Date value above limit %s", pFieldDefinition->szMaxValue);
+    return 4;
+  }
+
+  return 0;
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-void CheckForFileIndex(pchar *ppszFieldName, int *pnCsvFileIndex)
+int CheckDateLimits(cpchar pszValue, DateCodec const *pCodec, CPFieldDefinition pFieldDefinition)
 {
-  // checks column names with file index as praefix in the format ":2:column-name"
-  // removes file index from column name and stores file index in second parameter
-  //
-  pchar pPos = *ppszFieldName;
-  if (*pPos == ':') {
-    pPos++;
-    if (*pPos >= '0' && *pPos <= '9') {
-      if (pPos[1] >= '0' && pPos[1] <= '9')
-        pPos++;
-      if (pPos[1] == ':') {
-        pPos[1] = '\0';
-        *pnCsvFileIndex = atoi(*ppszFieldName + 1) - 1;
-        *ppszFieldName = pPos + 2;
-      }
-    }
-  }
+  // check date value with minimum and maximum date of the field definition
+  TypedValue Date;
+
+  if (!pFieldDefinition->pMinLimit && !pFieldDefinition->pMaxLimit)
+    return 0;
+
+  if (DecodeTypedDate(pszValue, pCodec, &Date) != TYPED_VALID)
+    return 0;  // invalid date is reported by the date mapping
+
+  return CheckTypedMinMaxValues(&Date, pFieldDefinition);
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-void LoadMinMaxValues(FieldMappingContext *pContext, cpchar szMinFieldName, cpchar szMaxFieldName)
+bool IsTypedValueInRange(CPFieldMapping pFieldMapping, int nCsvDataLine)
 {
-  if (!IsEmptyString(pContext->pFieldDefinition->szMinValue))
-    if (!ConvertNumber(pContext->pFieldDefinition->szMinValue, pContext->pFieldDefinition->cType, &pContext->pFieldDefinition->nMinValue, &pContext->pFieldDefinition->fMinValue)) {
-      LogMappingError(pContext->nMapIndex, GetOperationLongName(pContext->pFieldMapping->csv.cOperation), szMinFieldName, szLastError);
-      pContext->pFieldDefinition->szMinValue = szEmptyString;
-    }
-
-  if (!IsEmptyString(pContext->pFieldDefinition->szMaxValue))
-    if (!ConvertNumber(pContext->pFieldDefinition->szMaxValue, pContext->pFieldDefinition->cType, &pContext->pFieldDefinition->nMaxValue, &pContext->pFieldDefinition->fMaxValue)) {
-      LogMappingError(pContext->nMapIndex, GetOperationLongName(pContext->pFieldMapping->csv.cOperation), szMaxFieldName, szLastError);
-      pContext->pFieldDefinition->szMaxValue = szEmptyString;
-    }
+  // result of CheckTypedColumnLimits for this field mapping (false = not checked or out of range)
+  TypedColumn const *pTypedColumn = aLinkedCsvFile[pFieldMapping->nCsvFileIndex].aTypedColumn + pFieldMapping->nCsvIndex;
 
-  *szLastError = '\0';
+  return pTypedColumn->pRangeDefinition == &pFieldMapping->csv && (pTypedColumn->abInRange[nCsvDataLine >> 3] & (1 << (nCsvDataLine & 7)));
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-bool IsValidMappingFormat(cpchar szMappingFormat)
+TypedValue const *GetTypedCsvValue(CPFieldMapping pFieldMapping, int nCsvDataLine)
 {
-  // check syntax of mapping format columns
-  // Samples: "'PRAEFIX-'*", "*'-POSTFIX'"
+  // get decoded value of csv field (NULL = not decoded or invalid)
+  LinkedCsvFile *pLinkedCsvFile;
+  TypedColumn *pTypedColumn;
 
-  if (!*szMappingFormat)
-    return true;
+  if (nCsvDataLine < 0 || pFieldMapping->nCsvIndex < 0 || pFieldMapping->nCsvFileIndex < 0 || pFieldMapping->nCsvFileIndex >= nLinkedCsvFiles)
+    return NULL;
 
-  int len = strlen(szMappingFormat);
-  if (len < 4)
-    return false;
+  pLinkedCsvFile = aLinkedCsvFile + pFieldMapping->nCsvFileIndex;
+  if (!pLinkedCsvFile->aTypedColumn || nCsvDataLine >= pLinkedCsvFile->nRealDataLines || pFieldMapping->nCsvIndex >= pLinkedCsvFile->nColumns)
+    return NULL;
 
-  return (*szMappingFormat == '\'' && strncmp(szMappingFormat + len - 2, "'*", 2) == 0) || (strncmp(szMappingFormat, "*'", 2) == 0 && szMappingFormat[len-1] == '\'');
+  // column decoded with type (and format) of this field mapping ?
+  pTypedColumn = pLinkedCsvFile->aTypedColumn + pFieldMapping->nCsvIndex;
+  if (pTypedColumn->cType != pFieldMapping->csv.cType || pFieldMapping->xml.cType != pFieldMapping->csv.cType)
+    return NULL;
+  if (pFieldMapping->csv.Transform.nSteps > 0 || pFieldMapping->xml.Transform.nSteps > 0)
+    return NULL;  // decoded value is not transformed
+  if (pTypedColumn->cType == 'D'/*DATE*/ && strcmp(pTypedColumn->szFormat, pFieldMapping->csv.szFormat) != 0)
+    return NULL;
+
+  if (!(pTypedColumn->abValid[nCsvDataLine >> 3] & (1 << (nCsvDataLine & 7))))
+    return NULL;
+
+  return pTypedColumn->aValue + nCsvDataLine;
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-int ReadFieldMappings(const char *szFileName)
+int ConvertCsvBoolean(FieldMapping const *pFieldMapping, cpchar pCsvValue, pchar pXmlValue, int nMaxLen, bool bCheckLimits)
 {
-  // read mapping definition
-  int i, nMapIndex, nMapIndex2, nReturnCode, nNonEmptyFields;
-  char *pColumnName = NULL;
-  const char *pszValue = NULL;
-  FieldMapping *pFieldMapping, *pFieldMapping2;
-  pchar aField[MAX_MAPPING_COLUMNS];
-  FILE *pFile = NULL;
-  //errno_t error_code;
-  char szTemp[256];
+  (void)bCheckLimits;  // no limits for boolean values
 
-  // open csv file for input in binary mode (cr/lf are not changed)
-  //error_code = fopen_s(&pFile, szFileName, "rb");
-  pFile = fopen(szFileName, "rb");
-  if (!pFile) {
-    //sprintf(szLastError, "Cannot open mapping file '%s' (error code %d)", szFileName, error_code);
-    sprintf(szLastError, "Cannot open mapping file '%s'", szFileName);
-    puts(szLastError);
-    return -2;
-  }
+  if (LookupBooleanValue(&pFieldMapping->CsvToXmlBoolean, pCsvValue, pXmlValue, nMaxLen) == 0)
+    return 0;
 
-  // get file size
-  //int fseek(FILE *stream, long offset, int whence);
-  int iReturnCode = fseek(pFile, 0, SEEK_END);
-  int nFileSize = ftell(pFile);
+  return MapBoolFormat(pCsvValue, &pFieldMapping->csv, pXmlValue, &pFieldMapping->xml);
+}
 
-  // allocate reading buffer
-  nFieldMappingBufferSize = nFileSize + 1;
-  pFieldMappingsBuffer = (char*)malloc(nFieldMappingBufferSize);
+//--------------------------------------------------------------------------------------------------------
 
-  if (!pFieldMappingsBuffer) {
-    sprintf(szLastError, "Not enough memory for reading mapping file '%s' (%d bytes)", szFileName, nFileSize);
-    puts(szLastError);
-    return -1;  // not enough free memory
-  }
+int ConvertCsvDate(FieldMapping const *pFieldMapping, cpchar pCsvValue, pchar pXmlValue, int nMaxLen, bool bCheckLimits)
+{
+  int nErrorCode;
 
-  // clear read buffer
-  memset(pFieldMappingsBuffer, 0, nFieldMappingBufferSize);
+  if (pFieldMapping->xml.DateFormat.nLen > nMaxLen)
+    return -1;
 
-  // initialize list of root node attributes
-  RootAttrNameValueList.nCount = 0;
-  RootAttrNameValueList.nMaxCount = MAX_NODE_ATTRIBUTES;
-  RootAttrNameValueList.aAttrNameValue = (AttributeNameValue*)malloc(RootAttrNameValueList.nMaxCount * sizeof(AttributeNameValue));
+  nErrorCode = MapDateCodec(pCsvValue, &pFieldMapping->csv.DateFormat, pXmlValue, &pFieldMapping->xml.DateFormat);
+  if (nErrorCode > 0)
+    sprintf(szLastFieldMappingError, "Invalid date (does not match '%s')", pFieldMapping->csv.szFormat);
+  if (nErrorCode == 0 && bCheckLimits && CheckDateLimits(pCsvValue, &pFieldMapping->csv.DateFormat, &pFieldMapping->csv) != 0) {
+    *pXmlValue = '\0';
+    nErrorCode = 4;
+  }
 
-  // go to start of file
-  iReturnCode = fseek(pFile, 0, SEEK_SET);
+  return nErrorCode;
+}
 
-  // read file content
-  int nBytesRead = fread(pFieldMappingsBuffer, nFieldMappingBufferSize, 1, pFile);
+//--------------------------------------------------------------------------------------------------------
 
-  // close file
-  fclose(pFile);
+int ConvertCsvInteger(FieldMapping const *pFieldMapping, cpchar pCsvValue, pchar pXmlValue, int nMaxLen, bool bCheckLimits)
+{
+  int nErrorCode = MapIntFormat(pCsvValue, pFieldMapping->csv.szFormat, pXmlValue, pFieldMapping->xml.szFormat, nMaxLen);
 
-  // initialize reading position
-  char *pReadPos = pFieldMappingsBuffer;
+  if (nErrorCode == 0 && bCheckLimits)
+    nErrorCode = CheckMinMaxValues(pXmlValue, &pFieldMapping->csv);
+  if (nErrorCode > 0)
+    *pXmlValue = '\0';
 
-  // get header line with column names
-  char *pLine = GetNextLine(&pReadPos);
+  return nErrorCode;
+}
 
-  // parse header line
-  int nColumns = GetFields(pLine, ';', aField, MAX_MAPPING_COLUMNS);
-  int nCsvOpIdx = -1;
-  int nCsvContentIdx = -1;
-  int nCsvContent2Idx = -1;
-  int nCsvShortNameIdx = -1;
-  int nCsvMoIdx = -1;
-  int nCsvTypeIdx = -1;
-  int nCsvMinLenIdx = -1;
-  int nCsvMaxLenIdx = -1;
-  int nCsvMinValueIdx = -1;
-  int nCsvMaxValueIdx = -1;
-  int nCsvFormatIdx = -1;
-  int nCsvTransformIdx = -1;
-  int nCsvDefaultIdx = -1;
-  int nCsvConditionIdx = -1;
-  int nCsvMappingFormatIdx = -1;
-  int nXmlOpIdx = -1;
-  int nXmlContentIdx = -1;
-  int nXmlContent2Idx = -1;
-  int nXmlAttributeIdx = -1;
-  int nXmlShortNameIdx = -1;
-  int nXmlMoIdx = -1;
-  int nXmlTypeIdx = -1;
-  int nXmlMinLenIdx = -1;
-  int nXmlMaxLenIdx = -1;
-  int nXmlMinValueIdx = -1;
-  int nXmlMaxValueIdx = -1;
-  int nXmlFormatIdx = -1;
-  int nXmlTransformIdx = -1;
-  int nXmlDefaultIdx = -1;
-  int nXmlConditionIdx = -1;
-  int nXmlMappingFormatIdx = -1;
-  pchar szCsvOperation = NULL;
-  pchar szXmlOperation = NULL;
-  FieldMappingContext MappingContext;
+//--------------------------------------------------------------------------------------------------------
 
-  // find position of mapping columns
-  for (i = 0; i < nColumns; i++) {
-    pColumnName = aField[i];
-    // search for csv columns
-    if (strcmp(pColumnName, "CSV_OP") == 0) nCsvOpIdx = i;
-    if (strcmp(pColumnName, "CSV_CONTENT") == 0) nCsvContentIdx = i;
-    if (strcmp(pColumnName, "CSV_CONTENT2") == 0) nCsvContent2Idx = i;
-    if (strcmp(pColumnName, "CSV_SHORT_NAME") == 0) nCsvShortNameIdx = i;
-    if (strcmp(pColumnName, "CSV_MO") == 0) nCsvMoIdx = i;
-    if (strcmp(pColumnName, "CSV_TYPE") == 0) nCsvTypeIdx = i;
-    if (strcmp(pColumnName, "CSV_MIN_LEN") == 0) nCsvMinLenIdx = i;
-    if (strcmp(pColumnName, "CSV_MAX_LEN") == 0) nCsvMaxLenIdx = i;
-    if (strcmp(pColumnName, "CSV_MIN_VALUE") == 0) nCsvMinValueIdx = i;
-    if (strcmp(pColumnName, "CSV_MAX_VALUE") == 0) nCsvMaxValueIdx = i;
-    if (strcmp(pColumnName, "CSV_FORMAT") == 0) nCsvFormatIdx = i;
-    if (strcmp(pColumnName, "CSV_TRANSFORM") == 0) nCsvTransformIdx = i;
-    if (strcmp(pColumnName, "CSV_DEFAULT") == 0) nCsvDefaultIdx = i;
-    if (strcmp(pColumnName, "CSV_CONDITION") == 0) nCsvConditionIdx = i;
-    if (strcmp(pColumnName, "CSV_MAPPING_FORMAT") == 0) nCsvMappingFormatIdx = i;
-    // search for xml columns
-    if (strcmp(pColumnName, "XML_OP") == 0) nXmlOpIdx = i;
-    if (strcmp(pColumnName, "XML_CONTENT") == 0) nXmlContentIdx = i;
-    if (strcmp(pColumnName, "XML_CONTENT2") == 0) nXmlContent2Idx = i;
-    if (strcmp(pColumnName, "XML_ATTRIBUTE") == 0) nXmlAttributeIdx = i;
-    if (strcmp(pColumnName, "XML_SHORT_NAME") == 0) nXmlShortNameIdx = i;
-    if (strcmp(pColumnName, "XML_MO") == 0) nXmlMoIdx = i;
-    if (strcmp(pColumnName, "XML_TYPE") == 0) nXmlTypeIdx = i;
-    if (strcmp(pColumnName, "XML_MIN_LEN") == 0) nXmlMinLenIdx = i;
-    if (strcmp(pColumnName, "XML_MAX_LEN") == 0) nXmlMaxLenIdx = i;
-    if (strcmp(pColumnName, "XML_MIN_VALUE") == 0) nXmlMinValueIdx = i;
-    if (strcmp(pColumnName, "XML_MAX_VALUE") == 0) nXmlMaxValueIdx = i;
-    if (strcmp(pColumnName, "XML_FORMAT") == 0) nXmlFormatIdx = i;
-    if (strcmp(pColumnName, "XML_TRANSFORM") == 0) nXmlTransformIdx = i;
-    if (strcmp(pColumnName, "XML_DEFAULT") == 0) nXmlDefaultIdx = i;
-    if (strcmp(pColumnName, "XML_CONDITION") == 0) nXmlConditionIdx = i;
-    if (strcmp(pColumnName, "XML_MAPPING_FORMAT") == 0) nXmlMappingFormatIdx = i;
-  }
+int ConvertCsvNumber(FieldMapping const *pFieldMapping, cpchar pCsvValue, pchar pXmlValue, int nMaxLen, bool bCheckLimits)
+{
+  int nErrorCode = MapNumberFormat(pCsvValue, cDecimalPoint, pFieldMapping->csv.szFormat, pXmlValue, '.', pFieldMapping->xml.szFormat, nMaxLen);
 
-  if (nCsvOpIdx < 0 || nCsvContentIdx < 0 || nCsvTypeIdx < 0 || nXmlOpIdx < 0 || nXmlContentIdx < 0)
-    return -2;  // missing mandatory columns in mapping file
+  if (nErrorCode == 0 && bCheckLimits)
+    nErrorCode = CheckMinMaxValues(pXmlValue, &pFieldMapping->csv);
+  if (nErrorCode > 0)
+    *pXmlValue = '\0';
 
-  pFieldMapping = aFieldMapping;
+  return nErrorCode;
+}
 
-  // load field mapping definitions into mapping array
-  while (pLine = GetNextLine(&pReadPos)) {
-    nColumns = GetFields(pLine, ';', aField, MAX_MAPPING_COLUMNS);
+//--------------------------------------------------------------------------------------------------------
 
-    nNonEmptyFields = 0;
-    for (i = 0; i < nColumns; i++)
-      if (strlen(aField[i]) > 0)
-        nNonEmptyFields++;
+int ConvertCsvText(FieldMapping const *pFieldMapping, cpchar pCsvValue, pchar pXmlValue, int nMaxLen, bool bCheckLimits)
+{
+  (void)bCheckLimits;  // length and format are always checked
 
-    // line with real content ?
-    if (*pLine != '#' /*Comment*/ && nNonEmptyFields >= 3 && nFieldMappings < MAX_FIELD_MAPPINGS) {
-      nMapIndex = nFieldMappings;
-      MappingContext.aField = aField;
-      MappingContext.nFields = nColumns;
-      MappingContext.nMapIndex = nMapIndex;
-      MappingContext.pFieldMapping = pFieldMapping;
+  return MapTextFormat(pCsvValue, &pFieldMapping->csv, pXmlValue, &pFieldMapping->xml, nMaxLen);
+}
 
-      //pFieldMapping->csv = EmptyFieldDefinition;
-      MappingContext.pFieldDefinition = &pFieldMapping->csv;
-      pFieldMapping->csv.cOperation = LoadCharMappingField(&MappingContext, "CSV_OP", nCsvOpIdx, true, ",FIX,VAR,MAP,NOP,CHANGE,UNIQUE,IF,ADDFILE,", 'M');
-      pFieldMapping->csv.szContent = LoadTextMappingField(&MappingContext, "CSV_CONTENT", nCsvContentIdx, NULL);
-      pFieldMapping->csv.szContent2 = LoadTextMappingField(&MappingContext, "CSV_CONTENT2", nCsvContent2Idx, NULL);
-      pFieldMapping->csv.szAttribute = NULL; // not used at the moment
-      pFieldMapping->csv.szShortName = LoadTextMappingField(&MappingContext, "CSV_SHORT_NAME", nCsvShortNameIdx, NULL);
-      pFieldMapping->csv.bMandatory = LoadBoolMappingField(&MappingContext, "CSV_MO", nCsvMoIdx, "M", "O", false);
-      pFieldMapping->csv.cType = LoadCharMappingField(&MappingContext, "CSV_TYPE", nCsvTypeIdx, (pFieldMapping->csv.cOperation != 'N'), ",BOOLEAN,DATE,DATETIME,INTEGER,NUMBER,TEXT,", 'T');
-      pFieldMapping->csv.nMinLen = LoadIntMappingField(&MappingContext, "CSV_MIN_LEN", nCsvMinLenIdx, 0);
-      pFieldMapping->csv.nMaxLen = LoadIntMappingField(&MappingContext, "CSV_MAX_LEN", nCsvMaxLenIdx, -1);
-      pFieldMapping->csv.szMinValue = LoadTextMappingField(&MappingContext, "CSV_MIN_VALUE", nCsvMinValueIdx, NULL);
-      pFieldMapping->csv.szMaxValue = LoadTextMappingField(&MappingContext, "CSV_MAX_VALUE", nCsvMaxValueIdx, NULL);
-      pFieldMapping->csv.szFormat = LoadTextMappingField(&MappingContext, "CSV_FORMAT", nCsvFormatIdx, NULL);
-      pFieldMapping->csv.szTransform = LoadTextMappingField(&MappingContext, "CSV_TRANSFORM", nCsvTransformIdx, NULL);
-      pFieldMapping->csv.szDefault = LoadTextMappingField(&MappingContext, "CSV_DEFAULT", nCsvDefaultIdx, NULL);
-      pFieldMapping->csv.szCondition = LoadTextMappingField(&MappingContext, "CSV_CONDITION", nCsvConditionIdx, NULL);
-      pFieldMapping->csv.szMappingFormat = LoadTextMappingField(&MappingContext, "CSV_MAPPING_FORMAT", nCsvMappingFormatIdx, NULL);
-      LoadMinMaxValues(&MappingContext, "CSV_MIN_VALUE", "CSV_MAX_VALUE");
+//--------------------------------------------------------------------------------------------------------
 
-      //pFieldMapping->xml = EmptyFieldDefinition;
-      MappingContext.pFieldDefinition = &pFieldMapping->xml;
-      pFieldMapping->xml.cOperation = LoadCharMappingField(&MappingContext, "XML_OP", nXmlOpIdx, true, ",FIX,VAR,MAP,LOOP,IF,ROOT,", 0);
-      pFieldMapping->xml.szContent = LoadTextMappingField(&MappingContext, "XML_CONTENT", nXmlContentIdx, NULL);
-      pFieldMapping->xml.szContent2 = LoadTextMappingField(&MappingContext, "XML_CONTENT2", nXmlContent2Idx, NULL);
-      pFieldMapping->xml.szAttribute = LoadTextMappingField(&MappingContext, "XML_ATTRIBUTE", nXmlAttributeIdx, NULL);
-      pFieldMapping->xml.szShortName = LoadTextMappingField(&MappingContext, "XML_SHORT_NAME", nXmlShortNameIdx, NULL);
-      pFieldMapping->xml.bMandatory = LoadBoolMappingField(&MappingContext, "XML_MO", nXmlMoIdx, "M", "O", pFieldMapping->csv.bMandatory);
-      pFieldMapping->xml.bAddEmptyNodes = false;
-      pFieldMapping->xml.cType = LoadCharMappingField(&MappingContext, "XML_TYPE", nXmlTypeIdx, false, ",BOOLEAN,DATE,DATETIME,INTEGER,NUMBER,TEXT,", pFieldMapping->csv.cType);
-      pFieldMapping->xml.nMinLen = LoadIntMappingField(&MappingContext, "XML_MIN_LEN", nXmlMinLenIdx, pFieldMapping->csv.nMinLen);
-      pFieldMapping->xml.nMaxLen = LoadIntMappingField(&MappingContext, "XML_MAX_LEN", nXmlMaxLenIdx, pFieldMapping->csv.nMaxLen);
-      pFieldMapping->xml.szMinValue = LoadTextMappingField(&MappingContext, "XML_MIN_VALUE", nXmlMinValueIdx, NULL);
-      pFieldMapping->xml.szMaxValue = LoadTextMappingField(&MappingContext, "XML_MAX_VALUE", nXmlMaxValueIdx, NULL);
-      pFieldMapping->xml.szFormat = LoadTextMappingField(&MappingContext, "XML_FORMAT", nXmlFormatIdx, NULL);
-      pFieldMapping->xml.szTransform = LoadTextMappingField(&MappingContext, "XML_TRANSFORM", nXmlTransformIdx, NULL);
-      pFieldMapping->xml.szDefault = LoadTextMappingField(&MappingContext, "XML_DEFAULT", nXmlDefaultIdx, NULL);
-      pFieldMapping->xml.szCondition = LoadTextMappingField(&MappingContext, "XML_CONDITION", nXmlConditionIdx, NULL);
-      pFieldMapping->xml.Condition.pComplexCondition = NULL;
-      pFieldMapping->xml.Condition.pSimpleCondition = NULL;
-      pFieldMapping->xml.szMappingFormat = LoadTextMappingField(&MappingContext, "XML_MAPPING_FORMAT", nXmlMappingFormatIdx, NULL);
-      LoadMinMaxValues(&MappingContext, "XML_MIN_VALUE", "XML_MAX_VALUE");
+int ConvertXmlBoolean(FieldMapping const *pFieldMapping, cpchar pXmlValue, pchar pCsvValue, int nMaxLen)
+{
+  if (LookupBooleanValue(&pFieldMapping->XmlToCsvBoolean, pXmlValue, pCsvValue, nMaxLen) == 0)
+    return 0;
 
-      if (pFieldMapping->csv.cOperation == 'N'/*NOP*/ && pFieldMapping->xml.cOperation == 'R'/*ROOT*/) {
-        if (IsEmptyString(pFieldMapping->xml.szContent)) {
-          sprintf(szLastError, "Missing mandatory content");
-          LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->xml.cOperation), "XML_CONTENT", szLastError);
-        }
-        else {
-          if (IsEmptyString(pFieldMapping->xml.szAttribute))
-            mystrncpy(szRootNodeName, pFieldMapping->xml.szContent, MAX_NODE_NAME_SIZE);
-          else
-            SimpleAddAttributeToList(&RootAttrNameValueList, pFieldMapping->xml.szAttribute, pFieldMapping->xml.szContent);
-        }
-      }
-      else {
-        // add new mapping
-        pszValue = aField[nXmlTypeIdx];
-        if (strcmp(pszValue, "DATE") == 0 && strlen(pFieldMapping->xml.szFormat) < 10)
-          pFieldMapping->xml.szFormat = szXmlDateFormat;
-        if (strcmp(pszValue, "DATETIME") == 0 && strlen(pFieldMapping->xml.szFormat) < 19)
-          pFieldMapping->xml.szFormat = szXmlTimestampFormat;
+  return MapBoolFormat(pXmlValue, &pFieldMapping->xml, pCsvValue, &pFieldMapping->csv);
+}
 
-        // csv file indices
-        pFieldMapping->nCsvFileIndex = 0;
-        pFieldMapping->nCsvFileIndex2 = 0;
-        if (strchr("FV", pFieldMapping->csv.cOperation) == NULL) {
-          CheckForFileIndex((pchar*)&pFieldMapping->csv.szContent, &(pFieldMapping->nCsvFileIndex));
-          CheckForFileIndex((pchar*)&pFieldMapping->csv.szContent2, &(pFieldMapping->nCsvFileIndex2));
-        }
+//--------------------------------------------------------------------------------------------------------
 
-        if (pFieldMapping->csv.cOperation != 'F' && IsEmptyString(pFieldMapping->csv.szContent)) {
-          sprintf(szLastError, "Missing mandatory content");
-          LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->csv.cOperation), "CSV_CONTENT", szLastError);
-        }
+int ConvertXmlDate(FieldMapping const *pFieldMapping, cpchar pXmlValue, pchar pCsvValue, int nMaxLen)
+{
+  // csv and xml format specified in the mapping (compiled date codecs)
+  int nErrorCode;
 
-        if (pFieldMapping->xml.cOperation != 'F' && IsEmptyString(pFieldMapping->xml.szContent)) {
-          sprintf(szLastError, "Missing mandatory content");
-          LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->xml.cOperation), "XML_CONTENT", szLastError);
-        }
+  if (pFieldMapping->csv.DateFormat.nLen > nMaxLen)
+    return -1;
 
-        // check combination of mapping operations (csv/xml)
-        sprintf(szTemp, "%c%c", pFieldMapping->csv.cOperation, pFieldMapping->xml.cOperation);
-        if (!CheckRegex(szTemp, ",AM,FM,MF,VM,MV,MM,CL,UL,II,NR,")) {
-          sprintf(szLastError, "Invalid combination of csv and xml operation '%s'-'%s'", GetOperationLongName(pFieldMapping->csv.cOperation), GetOperationLongName(pFieldMapping->xml.cOperation));
-          LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->xml.cOperation), "XML_CONTENT", szLastError);
-        }
+  nErrorCode = CheckDateLimits(pXmlValue, &pFieldMapping->xml.DateFormat, &pFieldMapping->xml);
+  if (nErrorCode == 0)
+    nErrorCode = MapDateCodec(pXmlValue, &pFieldMapping->xml.DateFormat, pCsvValue, &pFieldMapping->csv.DateFormat);
+  if (nErrorCode > 0 && nErrorCode != 4)
+    sprintf(szLastFieldMappingError, "Invalid date (does not match '%s')", pFieldMapping->xml.szFormat);
+
+  return nErrorCode;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int ConvertXmlDefaultDate(FieldMapping const *pFieldMapping, cpchar pXmlValue, pchar pCsvValue, int nMaxLen)
+{
+  // default xml or csv date format (may be changed by parameters)
+  cpchar pszFromFormat = pFieldMapping->xml.szFormat;
+  cpchar pszToFormat = pFieldMapping->csv.szFormat;
+  int nErrorCode;
+
+  if (pszFromFormat == NULL || strlen(pszFromFormat) < 10)
+    pszFromFormat = szXmlDateFormat;
+  if (pszToFormat == NULL)
+    pszToFormat = szCsvDefaultDateFormat;
+
+  DateCodec FromCodec;
+
+  if ((int)strlen(pszToFormat) > nMaxLen)
+    return -1;
+
+  if (pFieldMapping->xml.pMinLimit || pFieldMapping->xml.pMaxLimit) {
+    CompileDateCodec(&FromCodec, pszFromFormat);
+    nErrorCode = CheckDateLimits(pXmlValue, &FromCodec, &pFieldMapping->xml);
+    if (nErrorCode != 0)
+      return nErrorCode;
+  }
+
+  nErrorCode = MapDateFormat(pXmlValue, pszFromFormat, pCsvValue, pszToFormat);
+  if (nErrorCode > 0)
+    sprintf(szLastFieldMappingError, "Invalid date (does not match '%s')", pszFromFormat);
+
+  return nErrorCode;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int ConvertXmlInteger(FieldMapping const *pFieldMapping, cpchar pXmlValue, pchar pCsvValue, int nMaxLen)
+{
+  int nErrorCode = CheckMinMaxValues(pXmlValue, &pFieldMapping->xml);
+
+  if (nErrorCode == 0)
+    nErrorCode = MapIntFormat(pXmlValue, pFieldMapping->xml.szFormat, pCsvValue, pFieldMapping->csv.szFormat, nMaxLen);
+
+  return nErrorCode;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int ConvertXmlNumber(FieldMapping const *pFieldMapping, cpchar pXmlValue, pchar pCsvValue, int nMaxLen)
+{
+  // map xml number to csv number format
+  int nErrorCode = CheckMinMaxValues(pXmlValue, &pFieldMapping->xml);
+
+  if (nErrorCode == 0)
+    nErrorCode = MapNumberFormat(pXmlValue, '.', pFieldMapping->xml.szFormat, pCsvValue, cDecimalPoint, pFieldMapping->csv.szFormat, nMaxLen);
+
+  return nErrorCode;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int ConvertXmlText(FieldMapping const *pFieldMapping, cpchar pXmlValue, pchar pCsvValue, int nMaxLen)
+{
+  return MapTextFormat(pXmlValue, &pFieldMapping->xml, pCsvValue, &pFieldMapping->csv, nMaxLen);
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void SelectValueConverters(FieldMapping *pFieldMapping)
+{
+  // select conversion functions for the combination of csv and xml type once after loading the mapping
+  // (values of different types are not converted)
+  pFieldMapping->pConvertCsvToXml = NULL;
+  pFieldMapping->pConvertXmlToCsv = NULL;
+
+  if (pFieldMapping->csv.cType != pFieldMapping->xml.cType)
+    return;
+
+  switch (pFieldMapping->csv.cType) {
+    case 'B'/*BOOLEAN*/:
+      pFieldMapping->pConvertCsvToXml = ConvertCsvBoolean;
+      pFieldMapping->pConvertXmlToCsv = ConvertXmlBoolean;
+      CompileBooleanLookup(&pFieldMapping->CsvToXmlBoolean, &pFieldMapping->csv, &pFieldMapping->xml);
+      CompileBooleanLookup(&pFieldMapping->XmlToCsvBoolean, &pFieldMapping->xml, &pFieldMapping->csv);
+      break;
+    case 'D'/*DATE*/:
+      pFieldMapping->pConvertCsvToXml = ConvertCsvDate;
+      if (pFieldMapping->xml.szFormat != NULL && strlen(pFieldMapping->xml.szFormat) >= 10 && pFieldMapping->csv.szFormat != NULL)
+        pFieldMapping->pConvertXmlToCsv = ConvertXmlDate;
+      else
+        pFieldMapping->pConvertXmlToCsv = ConvertXmlDefaultDate;
+      break;
+    case 'I'/*INTEGER*/:
+      pFieldMapping->pConvertCsvToXml = ConvertCsvInteger;
+      pFieldMapping->pConvertXmlToCsv = ConvertXmlInteger;
+      break;
+    case 'N'/*NUMBER*/:
+      pFieldMapping->pConvertCsvToXml = ConvertCsvNumber;
+      pFieldMapping->pConvertXmlToCsv = ConvertXmlNumber;
+      break;
+    case 'T'/*TEXT*/:
+      pFieldMapping->pConvertCsvToXml = ConvertCsvText;
+      pFieldMapping->pConvertXmlToCsv = ConvertXmlText;
+      break;
+  }
+}
+// end of function "SelectValueConverters"
+
+//--------------------------------------------------------------------------------------------------------
+
+void InternConstantXmlValues(FieldMapping *pFieldMapping)
+{
+  // values of FIX mappings and translated enumerations are interned once after loading the mapping
+  // (the xml document shares these strings instead of copying them for every node)
+  FormatMatcher const *pFormat = &pFieldMapping->xml.Format;
+  int i;
+
+  pFieldMapping->bConstantXmlValue = false;
+
+  if (convDir != CSV2XML || pFieldMapping->xml.cOperation != 'M'/*MAP*/ || !IsEmptyString(pFieldMapping->xml.szAttribute))
+    return;
+
+  if (pFieldMapping->csv.cOperation == 'F'/*FIX*/)
+    pFieldMapping->bConstantXmlValue = !IsEmptyString(pFieldMapping->csv.szContent);
+  else
+  if (pFieldMapping->csv.cOperation == 'M'/*MAP*/ && pFieldMapping->csv.cType == pFieldMapping->xml.cType && pFormat->cKind == 'E' &&
+      (pFieldMapping->xml.cType == 'B'/*BOOLEAN*/ || (pFieldMapping->xml.cType == 'T'/*TEXT*/ && pFieldMapping->csv.Format.cKind == 'E')))
+    pFieldMapping->bConstantXmlValue = true;
+
+  if (!pFieldMapping->bConstantXmlValue)
+    return;
+
+  if (!pConstantXmlValues)
+    pConstantXmlValues = xmlDictCreate();
+  if (!pConstantXmlValues) {
+    pFieldMapping->bConstantXmlValue = false;
+    return;
+  }
+
+  if (pFieldMapping->csv.cOperation == 'F'/*FIX*/)
+    xmlDictLookup(pConstantXmlValues, (const xmlChar *)pFieldMapping->csv.szContent, -1);
+  else
+    for (i = 0; i < pFormat->nItems; i++)
+      xmlDictLookup(pConstantXmlValues, (const xmlChar *)pFormat->aItem[i].pszValue, pFormat->aItem[i].nLen);
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+cpchar GetTransformArgument(cpchar pPos, cpchar *ppszArg, int *pnLen)
+{
+  // get argument of transform function ending with ',' or ')' (quoted arguments may contain these characters)
+  while (*pPos == ' ')
+    pPos++;
+
+  if (*pPos == '\'') {
+    *ppszArg = ++pPos;
+    while (*pPos && *pPos != '\'')
+      pPos++;
+    *pnLen = (int)(pPos - *ppszArg);
+    if (*pPos)
+      pPos++;
+  }
+  else {
+    *ppszArg = pPos;
+    while (*pPos && *pPos != ',' && *pPos != ')')
+      pPos++;
+    *pnLen = (int)(pPos - *ppszArg);
+    while (*pnLen > 0 && (*ppszArg)[*pnLen-1] == ' ')
+      (*pnLen)--;
+  }
+
+  while (*pPos == ' ')
+    pPos++;
+
+  return pPos;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int GetTransformNumber(cpchar pszArg, int nLen, int *pnValue)
+{
+  // positive number argument of transform function
+  int nValue = 0;
+
+  if (nLen <= 0 || nLen > 5)
+    return -1;
+
+  for (int i = 0; i < nLen; i++) {
+    if (pszArg[i] < '0' || pszArg[i] > '9')
+      return -1;
+    nValue = 10 * nValue + (pszArg[i] - '0');
+  }
+
+  *pnValue = nValue;
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int CompileValueTransform(cpchar pszTransform, ValueTransform *pTransform)
+{
+  // compile CSV_TRANSFORM or XML_TRANSFORM once after loading the mapping (error message in szLastError)
+  // steps separated by blanks are applied from left to right, e.g. "TRIM UPPER SUBSTR(1,12) LPAD(12,0) REPLACE(' ','_')"
+  //   TRIM, LTRIM, RTRIM   remove leading and/or trailing blanks
+  //   UPPER, LOWER         change case of the letters a-z
+  //   LEFT(n), RIGHT(n)    first or last n characters
+  //   SUBSTR(start[,len])  substring from start position (1 = first character)
+  //   LPAD(width[,char])   fill up to width characters at the beginning (default blank)
+  //   RPAD(width[,char])   fill up to width characters at the end (default blank)
+  //   REPLACE(from[,to])   replace every occurrence of from (quoted arguments may contain blanks, commas and brackets)
+  static const struct { cpchar pszName; char cOperation; int nMinArgs; int nMaxArgs; } aFunction[] = {
+    { "TRIM", 'T', 0, 0 }, { "LTRIM", 'L', 0, 0 }, { "RTRIM", 'R', 0, 0 }, { "UPPER", 'U', 0, 0 }, { "LOWER", 'D', 0, 0 },
+    { "LEFT", 'S', 1, 1 }, { "RIGHT", 'S', 1, 1 }, { "SUBSTR", 'S', 1, 2 }, { "LPAD", 'P', 1, 2 }, { "RPAD", 'Q', 1, 2 }, { "REPLACE", 'X', 1, 2 } };
+  cpchar pPos = pszTransform;
+  cpchar apszArg[2];
+  int anArgLen[2];
+  int i, nArgs, nNameLen, nFunction, nSteps = 0;
+  TransformStep *pStep;
+
+  pTransform->nSteps = 0;  // not transformed, if the transform contains errors
+
+  if (IsEmptyString(pszTransform))
+    return 0;
+
+  while (*pPos) {
+    if (*pPos == ' ') {
+      pPos++;
+      continue;
+    }
+
+    // name of function
+    for (nNameLen = 0; isalpha((unsigned char)pPos[nNameLen]); nNameLen++);
+    for (nFunction = 0; nFunction < (int)(sizeof(aFunction) / sizeof(aFunction[0])); nFunction++)
+      if ((int)strlen(aFunction[nFunction].pszName) == nNameLen && strnicmp(pPos, aFunction[nFunction].pszName, nNameLen) == 0)
+        break;
+    if (nNameLen == 0 || nFunction >= (int)(sizeof(aFunction) / sizeof(aFunction[0]))) {
+      sprintf(szLastError, "Unknown transform function '%.20s'", pPos);
+      return -1;
+    }
+    if (nSteps >= MAX_TRANSFORM_STEPS) {
+      sprintf(szLastError, "Too many transform functions (maximum %d)", MAX_TRANSFORM_STEPS);
+      return -1;
+    }
+    pPos += nNameLen;
+
+    // arguments in brackets
+    nArgs = 0;
+    if (*pPos == '(') {
+      pPos++;
+      for (;;) {
+        if (nArgs >= 2) {
+          sprintf(szLastError, "Too many arguments for transform function %s", aFunction[nFunction].pszName);
+          return -1;
+        }
+        pPos = GetTransformArgument(pPos, apszArg + nArgs, anArgLen + nArgs);
+        nArgs++;
+        if (*pPos != ',')
+          break;
+        pPos++;
+      }
+      if (*pPos != ')') {
+        sprintf(szLastError, "Closing bracket ')' expected for transform function %s", aFunction[nFunction].pszName);
+        return -1;
+      }
+      pPos++;
+    }
+    if (nArgs < aFunction[nFunction].nMinArgs || nArgs > aFunction[nFunction].nMaxArgs) {
+      sprintf(szLastError, "Invalid number of arguments for transform function %s", aFunction[nFunction].pszName);
+      return -1;
+    }
+    if (*pPos && *pPos != ' ') {
+      sprintf(szLastError, "Blank expected behind transform function %s", aFunction[nFunction].pszName);
+      return -1;
+    }
+
+    pStep = pTransform->aStep + nSteps;
+    memset(pStep, 0, sizeof(TransformStep));
+    pStep->cOperation = aFunction[nFunction].cOperation;
+    pStep->nArg2 = -1;
+
+    if (pStep->cOperation == 'X'/*REPLACE*/) {
+      pStep->pszFrom = apszArg[0];
+      pStep->nFromLen = anArgLen[0];
+      pStep->pszTo = (nArgs > 1) ? apszArg[1] : szEmptyString;
+      pStep->nToLen = (nArgs > 1) ? anArgLen[1] : 0;
+      if (pStep->nFromLen == 0) {
+        strcpy(szLastError, "Empty search string for transform function REPLACE");
+        return -1;
+      }
+    }
+    else
+    if (nArgs > 0) {
+      for (i = 0; i < nArgs; i++) {
+        if (i == 1 && strchr("PQ", pStep->cOperation)) {
+          // fill character
+          if (anArgLen[1] != 1) {
+            sprintf(szLastError, "One fill character expected for transform function %s", aFunction[nFunction].pszName);
+            return -1;
+          }
+          pStep->pszFrom = apszArg[1];
+          pStep->nFromLen = 1;
+        }
+        else
+        if (GetTransformNumber(apszArg[i], anArgLen[i], (i == 0) ? &pStep->nArg1 : &pStep->nArg2) != 0) {
+          sprintf(szLastError, "Invalid number for transform function %s", aFunction[nFunction].pszName);
+          return -1;
+        }
+      }
+      if (strchr("PQ", pStep->cOperation) && pStep->nArg1 >= MAX_VALUE_SIZE) {
+        sprintf(szLastError, "Width of transform function %s too large (maximum %d)", aFunction[nFunction].pszName, MAX_VALUE_SIZE - 1);
+        return -1;
+      }
+
+      // LEFT(n) = SUBSTR(1,n), RIGHT(n) = last n characters (start position 0)
+      if (aFunction[nFunction].pszName[0] == 'L' && pStep->cOperation == 'S') {
+        pStep->nArg2 = pStep->nArg1;
+        pStep->nArg1 = 1;
+      }
+      if (aFunction[nFunction].pszName[0] == 'R' && pStep->cOperation == 'S') {
+        pStep->nArg2 = pStep->nArg1;
+        pStep->nArg1 = 0;
+      }
+      if (pStep->cOperation == 'S' && pStep->nArg1 == 0 && aFunction[nFunction].pszName[0] == 'S') {
+        strcpy(szLastError, "Start position of transform function SUBSTR must be at least 1");
+        return -1;
+      }
+    }
+
+    nSteps++;
+  }
+
+  pTransform->nSteps = nSteps;
+  return 0;
+}
+// end of function "CompileValueTransform"
+
+//--------------------------------------------------------------------------------------------------------
+
+int ApplyValueTransform(ValueTransform const *pTransform, pchar pszValue, int nMaxLen)
+{
+  // apply compiled transform steps to the value in place (-1 = value buffer of nMaxLen characters is too small)
+  TransformStep const *pStep = pTransform->aStep;
+  int nLen = (int)strlen(pszValue);
+  int i, nStart;
+  pchar pPos;
+
+  for (int nStep = 0; nStep < pTransform->nSteps; nStep++, pStep++) {
+    switch (pStep->cOperation) {
+      case 'T'/*TRIM*/:
+      case 'L'/*LTRIM*/:
+        for (nStart = 0; nStart < nLen && pszValue[nStart] == ' '; nStart++);
+        if (nStart > 0) {
+          nLen -= nStart;
+          memmove(pszValue, pszValue + nStart, nLen + 1);
+        }
+        if (pStep->cOperation == 'L')
+          break;
+        // no break: TRIM removes trailing blanks as well
+      case 'R'/*RTRIM*/:
+        while (nLen > 0 && pszValue[nLen-1] == ' ')
+          nLen--;
+        pszValue[nLen] = '\0';
+        break;
+
+      case 'U'/*UPPER*/:
+        for (i = 0; i < nLen; i++)
+          if (pszValue[i] >= 'a' && pszValue[i] <= 'z')
+            pszValue[i] -= 'a' - 'A';
+        break;
+
+      case 'D'/*LOWER*/:
+        for (i = 0; i < nLen; i++)
+          if (pszValue[i] >= 'A' && pszValue[i] <= 'Z')
+            pszValue[i] += 'a' - 'A';
+        break;
+
+      case 'S'/*SUBSTR, LEFT, RIGHT*/:
+        nStart = (pStep->nArg1 > 0) ? pStep->nArg1 - 1 : ((nLen > pStep->nArg2) ? nLen - pStep->nArg2 : 0);
+        if (nStart > nLen)
+          nStart = nLen;
+        nLen -= nStart;
+        if (pStep->nArg2 >= 0 && nLen > pStep->nArg2)
+          nLen = pStep->nArg2;
+        if (nStart > 0)
+          memmove(pszValue, pszValue + nStart, nLen);
+        pszValue[nLen] = '\0';
+        break;
+
+      case 'P'/*LPAD*/:
+      case 'Q'/*RPAD*/:
+        if (nLen >= pStep->nArg1)
+          break;
+        if (pStep->nArg1 >= nMaxLen)
+          return -1;
+        if (pStep->cOperation == 'P') {
+          memmove(pszValue + pStep->nArg1 - nLen, pszValue, nLen + 1);
+          memset(pszValue, pStep->pszFrom ? *pStep->pszFrom : ' ', pStep->nArg1 - nLen);
+        }
+        else {
+          memset(pszValue + nLen, pStep->pszFrom ? *pStep->pszFrom : ' ', pStep->nArg1 - nLen);
+          pszValue[pStep->nArg1] = '\0';
+        }
+        nLen = pStep->nArg1;
+        break;
+
+      case 'X'/*REPLACE*/:
+        // (search string within the transform string is not zero terminated)
+        pPos = pszValue;
+        while (nLen - (pPos - pszValue) >= pStep->nFromLen) {
+          if (*pPos != *pStep->pszFrom || strncmp(pPos, pStep->pszFrom, pStep->nFromLen) != 0) {
+            pPos++;
+            continue;
+          }
+          if (pStep->nToLen != pStep->nFromLen) {
+            if (nLen + pStep->nToLen - pStep->nFromLen >= nMaxLen)
+              return -1;
+            memmove(pPos + pStep->nToLen, pPos + pStep->nFromLen, nLen - (pPos - pszValue) - pStep->nFromLen + 1);
+            nLen += pStep->nToLen - pStep->nFromLen;
+          }
+          memcpy(pPos, pStep->pszTo, pStep->nToLen);
+          pPos += pStep->nToLen;
+        }
+        break;
+    }
+  }
+
+  return 0;
+}
+// end of function "ApplyValueTransform"
+
+//--------------------------------------------------------------------------------------------------------
+
+int ConvertCsvToXmlValue(FieldMapping const *pFieldMapping, cpchar pCsvValue, pchar pXmlValue, int nMaxLen, bool bCheckLimits)
+{
+  // check csv value and transform it to xml format without logging errors (error message in szLastFieldMappingError)
+  // used by the generator and by the validation threads (no global state is changed except the thread local error text)
+  char szCsvValue[MAX_VALUE_SIZE];
+  int nErrorCode;
+
+  // csv value changed by CSV_TRANSFORM ?
+  if (pFieldMapping->csv.Transform.nSteps > 0) {
+    nErrorCode = ((int)strlen(pCsvValue) < MAX_VALUE_SIZE) ? 0 : -1;
+    if (nErrorCode == 0) {
+      strcpy(szCsvValue, pCsvValue);
+      nErrorCode = ApplyValueTransform(&pFieldMapping->csv.Transform, szCsvValue, MAX_VALUE_SIZE);
+    }
+    if (nErrorCode != 0) {
+      sprintf(szLastFieldMappingError, "Transformed value too long (maximum length %d)", MAX_VALUE_SIZE - 1);
+      *pXmlValue = '\0';
+      return 1;
+    }
+    pCsvValue = szCsvValue;
+  }
+
+  // mandatory field without content ?
+  if (!*pCsvValue && pFieldMapping->csv.bMandatory) {
+    strcpy(szLastFieldMappingError, "Mandatory field empty");
+    return 1;
+  }
+
+  // optional field without content or different types ?
+  if (!*pCsvValue || !pFieldMapping->pConvertCsvToXml)
+    return 0;  // nothing to do
+
+  nErrorCode = pFieldMapping->pConvertCsvToXml(pFieldMapping, pCsvValue, pXmlValue, nMaxLen, bCheckLimits);
+
+  // xml value changed by XML_TRANSFORM ?
+  if (nErrorCode == 0 && pFieldMapping->xml.Transform.nSteps > 0 && ApplyValueTransform(&pFieldMapping->xml.Transform, pXmlValue, nMaxLen) != 0) {
+    sprintf(szLastFieldMappingError, "Transformed value too long (maximum length %d)", nMaxLen - 1);
+    *pXmlValue = '\0';
+    nErrorCode = 1;
+  }
+
+  return nErrorCode;
+}
+// end of function "ConvertCsvToXmlValue"
+
+//--------------------------------------------------------------------------------------------------------
+
+int MapCsvToXmlValue(FieldMapping const *pFieldMapping, cpchar pCsvValue, pchar pXmlValue, int nMaxLen, int nCsvDataLine = -1)
+{
+  int nErrorCode = 0;
+  LinkedCsvFile *pLinkedCsvFile = aLinkedCsvFile + pFieldMapping->nCsvFileIndex;
+  TypedValue const *pTypedValue;
+  bool bValidated = false;
+
+  if (*pCsvValue) {
+    // value already decoded after reading the csv file (option -typed) ?
+    pTypedValue = GetTypedCsvValue(pFieldMapping, nCsvDataLine);
+    if (pTypedValue) {
+      nErrorCode = IsTypedValueInRange(pFieldMapping, nCsvDataLine) ? 0 : CheckTypedMinMaxValues(pTypedValue, &pFieldMapping->csv);
+      if (nErrorCode > 0) {
+        LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pFieldMapping->xml.szContent, pCsvValue, szLastFieldMappingError);
+        *pXmlValue = '\0';
+        return nErrorCode;
+      }
+      if (nErrorCode == 0 && FormatTypedValue(pTypedValue, pFieldMapping->xml.cType, &pFieldMapping->xml.DateFormat, pXmlValue, nMaxLen) == 0)
+        return 0;
+    }
+
+    // value already checked by the validation threads (option -threads) ?
+    bValidated = (nCsvDataLine >= 0 && pFieldMapping->anCellError && nCsvDataLine < aLinkedCsvFile[pFieldMapping->nCsvFileIndex].nRealDataLines && pFieldMapping->anCellError[nCsvDataLine] == 0);
+  }
+
+  // limits of valid values are not checked again
+  nErrorCode = ConvertCsvToXmlValue(pFieldMapping, pCsvValue, pXmlValue, nMaxLen, !bValidated);
+  if (nErrorCode > 0)
+    LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pFieldMapping->xml.szContent, pCsvValue, szLastFieldMappingError);
+
+  return nErrorCode;
+}
+// end of function "MapCsvToXmlValue"
+
+//--------------------------------------------------------------------------------------------------------
+
+int MapXmlToCsvValue(FieldMapping const *pFieldMapping, cpchar pXmlValue, cpchar pXPath, pchar pCsvValue, int nMaxLen)
+{
+  int nErrorCode = 0;
+  LinkedCsvFile *pLinkedCsvFile = aLinkedCsvFile + pFieldMapping->nCsvFileIndex;
+  char szXmlValue[MAX_VALUE_SIZE];
+
+  // xml value changed by XML_TRANSFORM ?
+  if (pFieldMapping->xml.Transform.nSteps > 0) {
+    nErrorCode = ((int)strlen(pXmlValue) < MAX_VALUE_SIZE) ? 0 : -1;
+    if (nErrorCode == 0) {
+      strcpy(szXmlValue, pXmlValue);
+      nErrorCode = ApplyValueTransform(&pFieldMapping->xml.Transform, szXmlValue, MAX_VALUE_SIZE);
+    }
+    if (nErrorCode != 0) {
+      sprintf(szLastFieldMappingError, "Transformed value too long (maximum length %d)", MAX_VALUE_SIZE - 1);
+      LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pXPath, pXmlValue, szLastFieldMappingError);
+      *pCsvValue = '\0';
+      return 1;
+    }
+    pXmlValue = szXmlValue;
+  }
+
+  // mandatory field without content ?
+  if (!*pXmlValue && pFieldMapping->xml.bMandatory) {
+    LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pXPath, pXmlValue, "Mandatory field missing or empty");
+    return 1;
+  }
+
+  if (pFieldMapping->pConvertXmlToCsv) {
+    nErrorCode = pFieldMapping->pConvertXmlToCsv(pFieldMapping, pXmlValue, pCsvValue, nMaxLen);
+    if (nErrorCode > 0)
+      LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pXPath, pXmlValue, szLastFieldMappingError);
+
+    // csv value changed by CSV_TRANSFORM ?
+    if (nErrorCode == 0 && pFieldMapping->csv.Transform.nSteps > 0 && ApplyValueTransform(&pFieldMapping->csv.Transform, pCsvValue, nMaxLen) != 0) {
+      sprintf(szLastFieldMappingError, "Transformed value too long (maximum length %d)", nMaxLen - 1);
+      LogXmlError(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pXPath, pXmlValue, szLastFieldMappingError);
+      *pCsvValue = '\0';
+      nErrorCode = 1;
+    }
+  }
+
+  return nErrorCode;
+}
+// end of function "MapXmlToCsvValue"
+
+//--------------------------------------------------------------------------------------------------------
+
+/*
+CSV_OP CSV_CONTENT    CSV_MO CSV_TYPE	CSV_MIN_LEN	CSV_MAX_LEN	CSV_FORMAT	CSV_DEFAULT	XML_OP	XML_CONTENT	XML_MO	XML_TYPE	XML_MIN_LEN	XML_MAX_LEN	XML_FORMAT	XML_DEFAULT
+FIX    Constant Value M      TEXT	3	3			FIX	Constant Value	M	TEXT	3	3
+VAR    Variables      O      INTEGER					VAR	Macro	O	INTEGER
+MAP    Column Name    M NUMBER					MAP	XPATH	M	NUMBER
+      DATE			DD.MM.YYYY					DATE
+      DATETIME								DATETIME
+      BOOLEAN			Ja/Nein					BOOLEAN
+*/
+
+//--------------------------------------------------------------------------------------------------------
+
+int NormalizeLineEnds(pchar pText)
+{
+  // convert line ends CR/LF and single CR to LF in one pass (in place) and return the exact number of lines
+  // (a last line without line end is counted, the text must be padded with READ_BUFFER_PADDING zero bytes)
+  pchar pRead = pText;
+  pchar pWrite = pText;
+  int nLines = 0;
+
+#ifdef USE_SSE2
+  __m128i vCR = _mm_set1_epi8('\r');
+  __m128i vLF = _mm_set1_epi8('\n');
+  __m128i vZero = _mm_setzero_si128();
+#endif
+
+  for (;;) {
+#ifdef USE_SSE2
+    // copy blocks of 16 characters without line end at once (nothing to copy before the first CR)
+    for (;;) {
+      __m128i block = _mm_loadu_si128((const __m128i*)pRead);
+      int nMask = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, vCR), _mm_cmpeq_epi8(block, vLF)), _mm_cmpeq_epi8(block, vZero)));
+      if (nMask) {
+        while (!(nMask & 1)) {
+          nMask >>= 1;
+          *pWrite++ = *pRead++;
+        }
+        break;
+      }
+      if (pWrite != pRead)
+        _mm_storeu_si128((__m128i*)pWrite, block);
+      pRead += 16;
+      pWrite += 16;
+    }
+#endif
+    if (*pRead == '\0')
+      break;  // end of text
+
+    if (*pRead == '\r') {
+      // CR/LF or single CR
+      pRead++;
+      if (*pRead == '\n')
+        pRead++;
+      *pWrite++ = '\n';
+      nLines++;
+    }
+    else {
+      if (*pRead == '\n')
+        nLines++;
+      *pWrite++ = *pRead++;
+    }
+  }
+
+  // last line without line end ?
+  if (pWrite > pText && pWrite[-1] != '\n')
+    nLines++;
+
+  // clear characters behind the shortened text
+  if (pWrite < pRead)
+    memset(pWrite, 0, pRead - pWrite);
+
+  return nLines;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+char *GetNextLine(pchar *ppReadPos)
+{
+  char *pReadPos = *ppReadPos;
+  char *pResult = pReadPos;
+
+  if (pReadPos && *pReadPos) {
+    pReadPos += strcspn(pReadPos, "\r\n");
+    if (*pReadPos) {
+      *pReadPos++ = '\0';
+      if (*pReadPos == '\n')
+        pReadPos++;
+    }
+    *ppReadPos = pReadPos;
+  }
+  else
+    pResult = NULL;
+
+  return pResult;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int GetFields(char *pLine, char cDelimiter, pchar *aField, int nMaxFields, bool *pbColumnQuoted = NULL)
+{
+  // parse line and returns pointers to field contents in aField array
+  char *pPos = pLine;
+  int nFields = 0;
+  char *pDelimiter = NULL;
+  char *pEnd = NULL;
+  char *pNext = NULL;
+
+  // skip spaces and tabs at the beginning of the field
+  while (*pPos && strchr(szIgnoreChars, *pPos))
+    pPos++;
+
+  while (*pPos && nFields < nMaxFields) {
+    if (*pPos == '"') {
+      // store flag that value has been quoted
+      if (pbColumnQuoted)
+        pbColumnQuoted[nFields] = true;
+
+      // store start address of current field
+      aField[nFields++] = ++pPos;
+
+      // search for end of string
+      pEnd = strchr(pPos, '"');
+      if (pEnd) {
+        *pEnd = '\0';
+        pPos = pEnd + 1;
+
+        // search for delimiter
+        pDelimiter = strchr(pPos, cDelimiter);
+        if (pDelimiter)
+          pPos = pDelimiter + 1;
+        else
+          pPos = strchr(pPos, '\0');  // end of line
+      }
+      else
+        pPos = strchr(pPos, '\0');  // end of line
+    }
+    else {
+      // store start address of current field
+      aField[nFields++] = pPos;
+
+      // search for next delimiter
+      pDelimiter = strchr(pPos, cDelimiter);
+
+      // get end of current field
+      if (pDelimiter) {
+        pEnd = pDelimiter;
+        pNext = pDelimiter + 1;
+      }
+      else {
+        pEnd = strchr(pPos, '\0');  // end of line
+        pNext = pEnd;
+      }
+
+      // skip spaces and tabs at the end of the field
+      while (pEnd > pPos && strchr(szIgnoreChars, *(pEnd-1)))
+        pEnd--;
+      *pEnd = '\0';
+
+      pPos = pNext;
+    }
+
+    // skip spaces and tabs at the beginning of the next field
+    while (*pPos && strchr(szIgnoreChars, *pPos))
+      pPos++;
+  }
+
+  return nFields;
+}
+// end of function "GetFields"
+
+//--------------------------------------------------------------------------------------------------------
+
+bool IsAcceptedCsvLine(cpchar pLine, int nMaxFields, int nKeyColumnIndex)
+{
+  // check csv data line against the row acceptance policy without parsing the fields
+  // (same field boundaries as function GetFields, stops as soon as the line is accepted)
+  cpchar pPos = pLine;
+  cpchar pEnd;
+  int nFields = 0, nNonEmptyFields = 0;
+  bool bNonEmpty, bKeyFound = (nKeyColumnIndex < 0);
+
+  // comment line ?
+  if (*szCommentPrefix && strncmp(pLine, szCommentPrefix, strlen(szCommentPrefix)) == 0)
+    return false;
+
+#ifdef USE_SSE2
+  __m128i vDelimiter = _mm_set1_epi8(cColumnDelimiter);
+  __m128i vSpace = _mm_set1_epi8(' ');
+  __m128i vTab = _mm_set1_epi8(strchr(szIgnoreChars, '\t') ? '\t' : ' ');
+#endif
+
+  // skip spaces and tabs at the beginning of the field
+  while (*pPos && strchr(szIgnoreChars, *pPos))
+    pPos++;
+
+  while (*pPos && nFields < nMaxFields) {
+#ifdef USE_SSE2
+    // skip blocks of 16 delimiters, spaces or tabs (empty fields) at once
+    // (the read buffer is padded with zero bytes, so blocks may be read behind the end of the line)
+    while (*pPos == cColumnDelimiter) {
+      __m128i block = _mm_loadu_si128((const __m128i*)pPos);
+      int nDelimiterMask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, vDelimiter));
+      int nMask = nDelimiterMask | _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, vSpace), _mm_cmpeq_epi8(block, vTab)));
+      if (nMask != 0xFFFF)
+        break;
+      for (; nDelimiterMask; nDelimiterMask &= nDelimiterMask - 1)
+        nFields++;
+      pPos += 16;
+    }
+    // the last block may end within the spaces and tabs at the beginning of a field
+    while (*pPos && strchr(szIgnoreChars, *pPos))
+      pPos++;
+    if (!*pPos || nFields >= nMaxFields)
+      break;
+#endif
+    if (*pPos == '"') {
+      // quoted field
+      bNonEmpty = (pPos[1] != '"' && pPos[1] != '\0');
+      pEnd = strchr(pPos + 1, '"');
+      if (pEnd) {
+        pPos = strchr(pEnd + 1, cColumnDelimiter);
+        pPos = pPos ? pPos + 1 : strchr(pEnd + 1, '\0');
+      }
+      else
+        pPos = strchr(pPos, '\0');  // end of line
+    }
+    else {
+      // field without quotes (spaces and tabs at the beginning have been skipped)
+      bNonEmpty = (*pPos != cColumnDelimiter);
+      pEnd = strchr(pPos, cColumnDelimiter);
+      pPos = pEnd ? pEnd + 1 : strchr(pPos, '\0');
+    }
+
+    if (bNonEmpty) {
+      nNonEmptyFields++;
+      if (nFields == nKeyColumnIndex)
+        bKeyFound = true;
+      if (bKeyFound && nNonEmptyFields >= nMinNonEmptyColumns)
+        return true;
+    }
+    nFields++;
+
+    // skip spaces and tabs at the beginning of the next field
+    while (*pPos && strchr(szIgnoreChars, *pPos))
+      pPos++;
+  }
+
+  return false;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int ParseSimpleCondition(pchar pszCondition, PSimpleCondition pSimpleCondition)
+{
+  // Parses conditions like "CCY != FUND_CCY" or "48_* = '1'" (mandatory space before and after operator !)
+  // Supported operators: "=", "!=", "<", ">"
+  //
+  // Input Parameters:
+  //   pszCondition .... string containing the condition (e.g. "CCY != FUND_CCY")
+  // 
+  // Result parameters:
+  //   *ppszLeftPart .... pointer to the left part of the condition (e.g. "CCY")
+  //   *ppszOperator .... pointer to the operator of the condition (e.g. "!=")
+  //   *ppszRightPart ... pointer to the right part of the condition (e.g. "FUND_CCY")
+  //
+  char szOperator[5];
+  char *pPos;
+  int len;
+
+  // initialize result parameters
+  pSimpleCondition->szLeftPart = NULL;
+  pSimpleCondition->szOperator = NULL;
+  pSimpleCondition->szRightPart = NULL;
+  pSimpleCondition->nLeftColumnIndex = -1;
+  pSimpleCondition->nRightColumnIndex = -1;
+
+  // search for operator !=
+  strcpy(szOperator, " != ");
+  pPos = strstr(pszCondition, szOperator);
+
+  if (!pPos) {
+    // search for operator =
+    strcpy(szOperator, " = ");
+    pPos = strstr(pszCondition, szOperator);
+  }
+
+  if (!pPos) {
+    // search for operator <
+    strcpy(szOperator, " < ");
+    pPos = strstr(pszCondition, szOperator);
+  }
+
+  if (!pPos) {
+    // search for operator >
+    strcpy(szOperator, " > ");
+    pPos = strstr(pszCondition, szOperator);
+  }
+
+  if (!pPos) {
+    sprintf(szLastError, "No compare operator found (' < ',' > ',' = ',' != ')");
+    pszLastErrorPos = pszCondition;
+    return 1;
+  }
+
+  // operator found
+  pSimpleCondition->szLeftPart = pszCondition;
+  *pPos++ = '\0';
+  pSimpleCondition->szOperator = pPos;
+  pPos += strlen(szOperator) - 2;
+  *pPos++ = '\0';
+  pSimpleCondition->szRightPart = pPos;
+
+  len = strlen(pPos);
+  if (*pPos == '\'' && len >= 2) {
+    // fill szCurrentValue with unquoted right part of condition (string content)
+    pSimpleCondition->szCurrentValue = (pchar)MyGetMemory(len-1);
+    if (pSimpleCondition->szCurrentValue)
+      mystrncpy(pSimpleCondition->szCurrentValue, pPos + 1, len-1);
+  }
+  else
+    pSimpleCondition->szCurrentValue = NULL;
+
+  return 0;
+}
+// end of function "ParseSimpleCondition"
+
+//--------------------------------------------------------------------------------------------------------
+
+PComplexCondition GetNewComplexCondition()
+{
+  PComplexCondition pComplexCondition = (PComplexCondition)MyGetMemory(sizeof(ComplexCondition));
+
+  if (pComplexCondition) {
+    pComplexCondition->LeftCondition.pComplexCondition = NULL;
+    pComplexCondition->LeftCondition.pSimpleCondition = NULL;
+    pComplexCondition->op = NO_OP;
+    pComplexCondition->RightCondition.pComplexCondition = NULL;
+    pComplexCondition->RightCondition.pSimpleCondition = NULL;
+  }
+
+  return pComplexCondition;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int ParseCondition(pchar pszCondition, PCondition pCondition, pchar *ppNext = NULL)
+{
+  // Parses conditions like "CCY != FUND_CCY" or "48_* = '1'" (mandatory space before and after operator !)
+  //   or like "((@fromCcy = xpath1) and (@toCcy = xpath2) and (@mulDiv = 'D')) or ((@fromCcy = xpath3) and (@toCcy = xpath4) and (@mulDiv = 'M'))"
+  //   or like "((@fromCcy = Funds/Fund/FundDynamicData/Portfolios/Portfolio/Positions/Position/Currency) and (@toCcy = Funds/Fund/Currency) and (@mulDiv = 'D')) or ((@fromCcy = Funds/Fund/Currency) and (@toCcy = Funds/Fund/FundDynamicData/Portfolios/Portfolio/Positions/Position/Currency) and (@mulDiv = 'M'))"
+  // Supported operators: "=", "!=", "<", ">"
+  //
+  pchar pPos = pszCondition;
+  pchar pOpeningBracket = NULL;
+  pchar pClosingBracket = NULL;
+  PComplexCondition pComplexCondition = NULL;
+  PComplexCondition pComplexSubCondition = NULL;
+  int nReturnCode, nLen;
+  bool bEnclosingBrackets = false;
+
+  pCondition->pComplexCondition = NULL;
+  pCondition->pSimpleCondition = NULL;
+
+  /*if (*pPos) {
+    pOpeningBracket = strchr(pPos+1, '(');
+    pClosingBracket = strchr(pPos+1, ')');
+    if (pClosingBracket < pOpeningBracket)
+      pOpeningBracket = NULL;  // opening bracket behind closing bracket
+  }*/
+
+  if (*pPos == '(' /*&& pOpeningBracket*/) {
+    // complex condition with logical operator
+    pPos++;
+    pCondition->pComplexCondition = pComplexCondition = GetNewComplexCondition();
+
+    nReturnCode = ParseCondition(pPos, &pComplexCondition->LeftCondition, &pPos);
+    if (nReturnCode != 0)
+      return nReturnCode;
+
+    while (*pPos == ' ')
+      pPos++;  // skip spaces
+
+    if (strnicmp(pPos, "and", 3) == 0) {
+      pComplexCondition->op = AND_OP;
+      pPos += 3;
+    }
+    else
+      if (strnicmp(pPos, "or", 2) == 0) {
+        pComplexCondition->op = OR_OP;
+        pPos += 2;
+      }
+      else {
+        sprintf(szLastError, "Missing logical operator ('and'/'or')");
+        pszLastErrorPos = pPos;
+        return 1;
+      }
+
+    while (*pPos == ' ')
+      pPos++;  // skip spaces
+
+    if (*pPos == '(')
+      pPos++;
+    else {
+      sprintf(szLastError, "Opening bracket '(' expected behind logical operator");
+      pszLastErrorPos = pPos;
+      return 3;
+    }
+
+    nReturnCode = ParseCondition(pPos, &pComplexCondition->RightCondition, &pPos);
+    if (nReturnCode != 0)
+      return nReturnCode;
+
+    while (*pPos == ' ')
+      pPos++;  // skip spaces
+
+    // more logical operators ?
+
+    while (strnicmp(pPos, "and", 3) == 0 || strnicmp(pPos, "or", 2) == 0) {
+      // add complex condition
+      pComplexSubCondition = GetNewComplexCondition();
+      // move old right condition to left condition of new complex condition (adding one level to condition tree)
+      pComplexSubCondition->LeftCondition = pComplexCondition->RightCondition;
+      pComplexCondition->RightCondition.pComplexCondition = pComplexSubCondition;
+      pComplexCondition->RightCondition.pSimpleCondition = NULL;
+
+      if (strnicmp(pPos, "and", 3) == 0) {
+        pComplexSubCondition->op = AND_OP;
+        nLen = 3;
+      }
+      else {
+        pComplexSubCondition->op = OR_OP;
+        nLen = 2;
+      }
+
+      if (pComplexCondition->op != pComplexSubCondition->op) {
+        sprintf(szLastError, "Logical operators (and/or) cannot be mixed on same level");
+        pszLastErrorPos = pPos;
+        return 2;
+      }
+
+      pPos += nLen;  // go to end of operator (and/or)
+
+      while (*pPos == ' ')
+        pPos++;  // skip spaces
+
+      if (*pPos == '(')
+        pPos++;
+      else {
+        sprintf(szLastError, "Opening bracket '(' expected behind logical operator");
+        pszLastErrorPos = pPos;
+        return 3;
+      }
+
+      nReturnCode = ParseCondition(pPos, &pComplexSubCondition->RightCondition, &pPos);
+      if (nReturnCode != 0)
+        return nReturnCode;
+
+      pComplexCondition = pComplexSubCondition;
+
+      while (*pPos == ' ')
+        pPos++;  // skip spaces
+    }
+
+    if (*pPos == ')')
+      pPos++;
+    else {
+      sprintf(szLastError, "Closing bracket ')' or logical operator ('and'/'or') expected");
+      pszLastErrorPos = pPos;
+      return 3;
+    }
+  }
+  else {
+    // simple condition
+    /*if (*pPos == '(') {
+      bEnclosingBrackets = true;
+      pPos++;
+    }*/
+
+    pClosingBracket = strchr(pPos, ')');
+    if (pClosingBracket)
+      *pClosingBracket = '\0';
+
+    pCondition->pSimpleCondition = (PSimpleCondition)MyGetMemory(sizeof(SimpleCondition));
+
+    nReturnCode = ParseSimpleCondition(pPos, pCondition->pSimpleCondition);
+    if (nReturnCode != 0)
+      return nReturnCode;
+
+    if (pClosingBracket)
+      pPos = pClosingBracket + 1;
+    else
+      pPos = strchr(pPos, '\0');
+  }
+
+  if (ppNext)
+    *ppNext = pPos;
+
+  return 0;
+}
+// end of function "ParseCondition"
+
+//--------------------------------------------------------------------------------------------------------
+
+int ParseCsvCondition(pchar pszCondition, PCondition pCondition)
+{
+  // Parses csv conditions like "CCY != FUND_CCY" or "(CCY = 'EUR') or (CCY = 'USD')"
+  // (column indices of the condition are resolved after reading the csv header line)
+  int nReturnCode, nBrackets = 0;
+  bool bQuoted = false;
+  pchar pszComplexCondition;
+
+  pCondition->pComplexCondition = NULL;
+  pCondition->pSimpleCondition = NULL;
+
+  if (*pszCondition == '(') {
+    // ParseCondition expects the closing bracket of the complex condition behind the last simple condition,
+    // e.g. "(CCY = 'EUR') or (CCY = 'USD'))", so it is added to conditions with balanced brackets
+    for (cpchar p = pszCondition; *p; p++) {
+      if (*p == '\'')
+        bQuoted = !bQuoted;
+      else
+      if (!bQuoted)
+        nBrackets += (*p == '(') ? 1 : ((*p == ')') ? -1 : 0);
+    }
+    if (nBrackets == 0) {
+      pszComplexCondition = (pchar)MyGetMemory(strlen(pszCondition) + 2);
+      if (!pszComplexCondition)
+        return 1;
+      strcpy(pszComplexCondition, pszCondition);
+      strcat(pszComplexCondition, ")");
+      pszCondition = pszComplexCondition;
+    }
+    nReturnCode = ParseCondition(pszCondition, pCondition);
+  }
+  else {
+    // simple condition (may contain brackets within quoted value)
+    pCondition->pSimpleCondition = (PSimpleCondition)MyGetMemory(sizeof(SimpleCondition));
+    nReturnCode = pCondition->pSimpleCondition ? ParseSimpleCondition(pszCondition, pCondition->pSimpleCondition) : 1;
+  }
+
+  if (nReturnCode != 0) {
+    pCondition->pComplexCondition = NULL;
+    pCondition->pSimpleCondition = NULL;
+  }
+
+  return nReturnCode;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void SimpleAddAttributeToList(AttributeNameValueList *pAttrNameValueList, cpchar pszAttrName, cpchar pszAttrValue)
+{
+  if (pAttrNameValueList->nCount >= pAttrNameValueList->nMaxCount)
+    return;  // error
+
+  AttributeNameValue *pAttrNameValue = pAttrNameValueList->aAttrNameValue + pAttrNameValueList->nCount;
+  mystrncpy(pAttrNameValue->szName, pszAttrName, MAX_ATTR_NAME_SIZE);
+  mystrncpy(pAttrNameValue->szValue, pszAttrValue, MAX_ATTR_VALUE_SIZE);
+  pAttrNameValue->pszXPath = NULL;
+  pAttrNameValueList->nCount++;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void AddAttributeToList(AttributeNameValueList *pAttrNameValueList, PCondition pCondition)
+{
+  if (pCondition->pComplexCondition) {
+    AddAttributeToList(pAttrNameValueList, &pCondition->pComplexCondition->LeftCondition);
+    if (pCondition->pComplexCondition->op == AND_OP)
+      AddAttributeToList(pAttrNameValueList, &pCondition->pComplexCondition->RightCondition);
+  }
+  
+  if (pCondition->pSimpleCondition && *pCondition->pSimpleCondition->szLeftPart == '@' && strcmp(pCondition->pSimpleCondition->szOperator, "=") == 0) {
+    if (pAttrNameValueList->nCount >= pAttrNameValueList->nMaxCount)
+      return;  // error
+
+    mystrncpy(pAttrNameValueList->aAttrNameValue[pAttrNameValueList->nCount].szName, pCondition->pSimpleCondition->szLeftPart + 1, MAX_ATTR_NAME_SIZE);
+
+    if (*pCondition->pSimpleCondition->szRightPart == '\'') {
+      mystrncpy(pAttrNameValueList->aAttrNameValue[pAttrNameValueList->nCount].szValue, pCondition->pSimpleCondition->szRightPart + 1, MAX_ATTR_VALUE_SIZE);
+      RemoveLastChar(pAttrNameValueList->aAttrNameValue[pAttrNameValueList->nCount].szValue, '\'');
+      pAttrNameValueList->aAttrNameValue[pAttrNameValueList->nCount].pszXPath = NULL;
+    }
+    else {
+      strcpy(pAttrNameValueList->aAttrNameValue[pAttrNameValueList->nCount].szValue, szEmptyString);
+      pAttrNameValueList->aAttrNameValue[pAttrNameValueList->nCount].pszXPath = pCondition->pSimpleCondition->szRightPart;
+    }
+
+    pAttrNameValueList->nCount++;
+  }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void GetAttributeList(AttributeNameValueList *pAttrNameValueList, PCondition pCondition)
+{
+  // Parses conditions like "CCY != FUND_CCY" or "48_* = '1'" (mandatory space before and after operator !)
+  //   or like "((@fromCcy = Funds/Fund/FundDynamicData/Portfolios/Portfolio/Positions/Position/Currency) and (@toCcy = Funds/Fund/Currency) and (@mulDiv = 'D')) or ((@fromCcy = Funds/Fund/Currency) and (@toCcy = Funds/Fund/FundDynamicData/Portfolios/Portfolio/Positions/Position/Currency) and (@mulDiv = 'M'))" ?
+
+  pAttrNameValueList->nCount = 0;
+  AddAttributeToList(pAttrNameValueList, pCondition);
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+typedef struct {
+  pchar *aField;
+  int nFields;
+  int nMapIndex;
+  FieldMapping *pFieldMapping;
+  FieldDefinition *pFieldDefinition;
+} FieldMappingContext;
+
+//--------------------------------------------------------------------------------------------------------
+
+pchar LoadTextMappingField(FieldMappingContext const *pContext, cpchar pszFieldName, int nFieldIndex, /*bool bMandatory,*/ cpchar pszValidContent)
+{
+  pchar pszResult = (pchar)szEmptyString;
+
+  if (nFieldIndex >= 0 && nFieldIndex < pContext->nFields) {
+    pszResult = pContext->aField[nFieldIndex];
+
+    // check content
+    if ((!IsEmptyString(pszValidContent) /*|| bMandatory*/) && !CheckRegex(pszResult, pszValidContent)) {
+      sprintf(szLastError, "Invalid content '%s' (not in '%s')", pszResult, pszValidContent+1);
+      LogMappingError(pContext->nMapIndex, GetOperationLongName(pContext->pFieldDefinition->cOperation), pszFieldName, szLastError);
+      pszResult = (pchar)szEmptyString;
+    }
+    else {
+      int nLen = strlen(pszResult);
+      if ((strcmp(pszFieldName, "CSV_FORMAT") == 0 || strcmp(pszFieldName, "XML_FORMAT") == 0) && nLen >= 3 && *pszResult == '(' && pszResult[nLen-1] == ')') {
+        // change first and last character to comma for easier check of content (comma+text+comma must be part of this string)
+        *pszResult = ',';
+        pszResult[nLen-1] = ',';
+      }
+    }
+  }
+
+  return pszResult;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+bool LoadBoolMappingField(FieldMappingContext const *pContext, cpchar pszFieldName, int nFieldIndex, cpchar pszTrue, cpchar pszFalse, bool bDefault)
+{
+  bool bResult = bDefault;
+  pchar pszContent = NULL;
+
+  if (nFieldIndex >= 0 && nFieldIndex < pContext->nFields) {
+    pszContent = pContext->aField[nFieldIndex];
+    if (!IsEmptyString(pszContent)) {
+      if (strnicmp(pszContent, pszTrue, strlen(pszTrue)) == 0)
+        bResult = true;
+      else
+        if (strnicmp(pszContent, pszFalse, strlen(pszFalse)) == 0)
+          bResult = false;
+        else {
+          sprintf(szLastError, "Invalid content '%s' (not in '%s,%s')", pszContent, pszTrue, pszFalse);
+          LogMappingError(pContext->nMapIndex, GetOperationLongName(pContext->pFieldDefinition->cOperation), pszFieldName, szLastError);
+        }
+    }
+  }
+
+  return bResult;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+char LoadCharMappingField(FieldMappingContext const *pContext, cpchar pszFieldName, int nFieldIndex, bool bMandatory, cpchar pszValidContent, char cDefault)
+{
+  char cResult = cDefault;
+  pchar pszContent = NULL;
+  bool bOK;
+
+  if (nFieldIndex >= 0 && nFieldIndex < pContext->nFields) {
+    // check content
+    pszContent = pContext->aField[nFieldIndex];
+    bOK = IsEmptyString(pszContent) ? !bMandatory : CheckRegex(pszContent, pszValidContent);
+    if (bOK)
+      cResult = toupper(*pszContent);
+    else {
+      sprintf(szLastError, "Invalid content '%s' (not in '%s')", pszContent, pszValidContent+1);
+      LogMappingError(pContext->nMapIndex, GetOperationLongName(pContext->pFieldDefinition->cOperation), pszFieldName, szLastError);
+    }
+  }
+
+  return cResult;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int LoadIntMappingField(FieldMappingContext const *pContext, cpchar pszFieldName, int nFieldIndex, int nDefault)
+{
+  int nResult = nDefault;
+  pchar pszContent = NULL;
+
+  if (nFieldIndex >= 0 && nFieldIndex < pContext->nFields) {
+    pszContent = pContext->aField[nFieldIndex];
+    // TODO: check content
+    if (*pszContent >= '0' && *pszContent <= '9')
+      nResult = atoi(pszContent);
+  }
+
+  return nResult;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void CheckForFileIndex(pchar *ppszFieldName, int *pnCsvFileIndex)
+{
+  // checks column names with file index as praefix in the format ":2:column-name"
+  // removes file index from column name and stores file index in second parameter
+  //
+  pchar pPos = *ppszFieldName;
+  if (*pPos == ':') {
+    pPos++;
+    if (*pPos >= '0' && *pPos <= '9') {
+      if (pPos[1] >= '0' && pPos[1] <= '9')
+        pPos++;
+      if (pPos[1] == ':') {
+        pPos[1] = '\0';
+        *pnCsvFileIndex = atoi(*ppszFieldName + 1) - 1;
+        *ppszFieldName = pPos + 2;
+      }
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+RangeLimit *GetRangeLimit(cpchar pszLimit, char cType, cpchar pszDateFormat)
+{
+  // decode minimum or maximum value once (NULL = invalid date or not enough memory)
+  RangeLimit *pLimit = (RangeLimit*)malloc(sizeof(RangeLimit));
+  DateCodec Codec;
+  TypedValue Date;
+  int i;
+
+  if (!pLimit)
+    return NULL;
+
+  memset(pLimit, 0, sizeof(RangeLimit));
+
+  if (cType == 'D'/*DATE*/) {
+    // date (and time) in the format of the field
+    CompileDateCodec(&Codec, pszDateFormat);
+    if (DecodeTypedDate(pszLimit, &Codec, &Date) != TYPED_VALID) {
+      sprintf(szLastError, "Invalid date limit (does not match '%s')", pszDateFormat);
+      free(pLimit);
+      return NULL;
+    }
+    pLimit->nValue = Date.nValue;
+    pLimit->nExtra = Date.nExtra;
+    pLimit->bBinary = true;
+    return pLimit;
+  }
+
+  // exact integer or number, binary mantissa if the significant digits fit
+  ScanNumber(pszLimit, (cType == 'N'/*NUMBER*/) ? cDecimalPoint : '\0', " ", NULL, '\0', &pLimit->Number);
+  if (pLimit->Number.nDigits <= 18) {
+    for (i = 0; i < pLimit->Number.nDigits; i++)
+      pLimit->nValue = 10 * pLimit->nValue + (pLimit->Number.acDigits[i] - '0');
+    if (pLimit->Number.bNegative)
+      pLimit->nValue = -pLimit->nValue;
+    pLimit->nExtra = pLimit->Number.nDigits - pLimit->Number.nIntDigits;
+    pLimit->bBinary = true;
+  }
+
+  return pLimit;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void LoadMinMaxValues(FieldMappingContext *pContext, cpchar szMinFieldName, cpchar szMaxFieldName)
+{
+  FieldDefinition *pFieldDefinition = pContext->pFieldDefinition;
+  cpchar pszDateFormat = pFieldDefinition->szFormat;
+
+  pFieldDefinition->pMinLimit = NULL;
+  pFieldDefinition->pMaxLimit = NULL;
+
+  // date limits in the format of the field (or the default format of the conversion)
+  if (pFieldDefinition == &pContext->pFieldMapping->csv && IsEmptyString(pszDateFormat))
+    pszDateFormat = szCsvDefaultDateFormat;
+  if (pFieldDefinition == &pContext->pFieldMapping->xml && (pszDateFormat == NULL || strlen(pszDateFormat) < 10))
+    pszDateFormat = szXmlDateFormat;
+
+  if (!IsEmptyString(pFieldDefinition->szMinValue)) {
+    if (pFieldDefinition->cType == 'D'/*DATE*/)
+      pFieldDefinition->pMinLimit = GetRangeLimit(pFieldDefinition->szMinValue, pFieldDefinition->cType, pszDateFormat);
+    else
+    if (ConvertNumber(pFieldDefinition->szMinValue, pFieldDefinition->cType, &pFieldDefinition->nMinValue, &pFieldDefinition->fMinValue))
+      pFieldDefinition->pMinLimit = GetRangeLimit(pFieldDefinition->szMinValue, pFieldDefinition->cType, NULL);
+
+    if (!pFieldDefinition->pMinLimit) {
+      LogMappingError(pContext->nMapIndex, GetOperationLongName(pContext->pFieldMapping->csv.cOperation), szMinFieldName, szLastError);
+      pFieldDefinition->szMinValue = szEmptyString;
+    }
+  }
+
+  if (!IsEmptyString(pFieldDefinition->szMaxValue)) {
+    if (pFieldDefinition->cType == 'D'/*DATE*/)
+      pFieldDefinition->pMaxLimit = GetRangeLimit(pFieldDefinition->szMaxValue, pFieldDefinition->cType, pszDateFormat);
+    else
+    if (ConvertNumber(pFieldDefinition->szMaxValue, pFieldDefinition->cType, &pFieldDefinition->nMaxValue, &pFieldDefinition->fMaxValue))
+      pFieldDefinition->pMaxLimit = GetRangeLimit(pFieldDefinition->szMaxValue, pFieldDefinition->cType, NULL);
+
+    if (!pFieldDefinition->pMaxLimit) {
+      LogMappingError(pContext->nMapIndex, GetOperationLongName(pContext->pFieldMapping->csv.cOperation), szMaxFieldName, szLastError);
+      pFieldDefinition->szMaxValue = szEmptyString;
+    }
+  }
+
+  *szLastError = '\0';
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+bool IsValidMappingFormat(cpchar szMappingFormat)
+{
+  // check syntax of mapping format columns
+  // Samples: "'PRAEFIX-'*", "*'-POSTFIX'"
+
+  if (!*szMappingFormat)
+    return true;
+
+  int len = strlen(szMappingFormat);
+  if (len < 4)
+    return false;
+
+  return (*szMappingFormat == '\'' && strncmp(szMappingFormat + len - 2, "'*", 2) == 0) || (strncmp(szMappingFormat, "*'", 2) == 0 && szMappingFormat[len-1] == '\'');
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void FreeNameIndex(NameIndex *pIndex)
+{
+  free(pIndex->aNode);
+  free(pIndex->anEdgeKey);
+  free(pIndex->anEdgeChild);
+  free(pIndex->aEntry);
+  memset(pIndex, 0, sizeof(NameIndex));
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int GetNameIndexSlot(const NameIndex *pIndex, int nKey)
+{
+  // get hash table slot of child link (existing or empty slot)
+  unsigned int nHash = (unsigned int)nKey * 0x9E3779B1u;
+  int nSlot = (int)((nHash ^ (nHash >> 15)) & (pIndex->nEdgeSlots - 1));
+
+  while (pIndex->anEdgeKey[nSlot] >= 0 && pIndex->anEdgeKey[nSlot] != nKey)
+    nSlot = (nSlot + 1) & (pIndex->nEdgeSlots - 1);
+
+  return nSlot;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int GetNameIndexChild(const NameIndex *pIndex, int nNode, char c)
+{
+  // get child node for next (case insensitive) character of name
+  if (pIndex->nEdgeSlots == 0)
+    return -1;
+
+  int nSlot = GetNameIndexSlot(pIndex, nNode * 256 + tolower((unsigned char)c));
+
+  return (pIndex->anEdgeKey[nSlot] >= 0) ? pIndex->anEdgeChild[nSlot] : -1;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int AddNameIndexChild(NameIndex *pIndex, int nNode, char c)
+{
+  // get or create child node for next (case insensitive) character of name
+  int i, nSlot, nChild;
+
+  nChild = GetNameIndexChild(pIndex, nNode, c);
+  if (nChild >= 0)
+    return nChild;
+
+  if (pIndex->nNodes >= pIndex->nMaxNodes) {
+    // enlarge node array
+    int nMaxNodes = pIndex->nMaxNodes ? 2 * pIndex->nMaxNodes : 256;
+    NameIndexNode *aNode = (NameIndexNode*)realloc(pIndex->aNode, nMaxNodes * sizeof(NameIndexNode));
+    if (!aNode)
+      return -1;
+    pIndex->aNode = aNode;
+    pIndex->nMaxNodes = nMaxNodes;
+  }
+
+  if (2 * pIndex->nNodes >= pIndex->nEdgeSlots) {
+    // enlarge hash table of child links (load factor below 0.5)
+    int nOldSlots = pIndex->nEdgeSlots;
+    int *anOldKey = pIndex->anEdgeKey;
+    int *anOldChild = pIndex->anEdgeChild;
+    int nEdgeSlots = nOldSlots ? 2 * nOldSlots : 512;
+    int *anEdgeKey = (int*)malloc(nEdgeSlots * sizeof(int));
+    int *anEdgeChild = (int*)malloc(nEdgeSlots * sizeof(int));
+    if (!anEdgeKey || !anEdgeChild) {
+      free(anEdgeKey);
+      free(anEdgeChild);
+      return -1;
+    }
+    memset(anEdgeKey, -1, nEdgeSlots * sizeof(int));
+    pIndex->nEdgeSlots = nEdgeSlots;
+    pIndex->anEdgeKey = anEdgeKey;
+    pIndex->anEdgeChild = anEdgeChild;
+    for (i = 0; i < nOldSlots; i++)
+      if (anOldKey[i] >= 0) {
+        nSlot = GetNameIndexSlot(pIndex, anOldKey[i]);
+        anEdgeKey[nSlot] = anOldKey[i];
+        anEdgeChild[nSlot] = anOldChild[i];
+      }
+    free(anOldKey);
+    free(anOldChild);
+  }
+
+  // create new node
+  nChild = pIndex->nNodes++;
+  pIndex->aNode[nChild].nExactEntry = -1;
+  pIndex->aNode[nChild].nPrefixEntry = -1;
+  pIndex->aNode[nChild].nMinValue = -1;
+
+  if (nChild > 0) {
+    // link new node to parent node
+    int nKey = nNode * 256 + tolower((unsigned char)c);
+    nSlot = GetNameIndexSlot(pIndex, nKey);
+    pIndex->anEdgeKey[nSlot] = nKey;
+    pIndex->anEdgeChild[nSlot] = nChild;
+  }
+
+  return nChild;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int AddNameIndexEntry(NameIndex *pIndex, cpchar pszName, int nValue)
+{
+  // add name or name pattern "prefix*" (same semantic as function MatchingColumnName)
+  int nNode = 0;
+
+  if (!pszName || !*pszName)
+    return 0;
+
+  int nLength = strlen(pszName);
+  bool bPrefix = (nLength > 1 && pszName[nLength - 1] == '*');
+  if (bPrefix)
+    nLength--;
+
+  // create root node
+  if (pIndex->nNodes == 0 && AddNameIndexChild(pIndex, 0, '\0') < 0)
+    return -1;
+
+  for (int i = 0; i <= nLength && nNode >= 0; i++) {
+    // update minimum value of names within subtree
+    if (!bPrefix && (pIndex->aNode[nNode].nMinValue < 0 || nValue < pIndex->aNode[nNode].nMinValue))
+      pIndex->aNode[nNode].nMinValue = nValue;
+    if (i < nLength)
+      nNode = AddNameIndexChild(pIndex, nNode, pszName[i]);
+  }
+
+  if (nNode < 0)
+    return -1;
+
+  if (pIndex->nEntries >= pIndex->nMaxEntries) {
+    // enlarge entry array
+    int nMaxEntries = pIndex->nMaxEntries ? 2 * pIndex->nMaxEntries : 64;
+    NameIndexEntry *aEntry = (NameIndexEntry*)realloc(pIndex->aEntry, nMaxEntries * sizeof(NameIndexEntry));
+    if (!aEntry)
+      return -1;
+    pIndex->aEntry = aEntry;
+    pIndex->nMaxEntries = nMaxEntries;
+  }
+
+  // add entry to list of node
+  NameIndexEntry *pEntry = pIndex->aEntry + pIndex->nEntries;
+  NameIndexNode *pNode = pIndex->aNode + nNode;
+  pEntry->nValue = nValue;
+  if (bPrefix) {
+    pEntry->nNextEntry = pNode->nPrefixEntry;
+    pNode->nPrefixEntry = pIndex->nEntries++;
+  }
+  else {
+    pEntry->nNextEntry = pNode->nExactEntry;
+    pNode->nExactEntry = pIndex->nEntries++;
+  }
+
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int FindNameIndexMatches(const NameIndex *pIndex, cpchar pszName, int *anValue, int nMaxValues)
+{
+  // get values of all names and name patterns matching the given name
+  int nEntry, nValues = 0, nNode = 0;
+
+  if (!pszName || !*pszName || pIndex->nNodes == 0)
+    return 0;
+
+  for (cpchar pc = pszName; *pc; pc++) {
+    nNode = GetNameIndexChild(pIndex, nNode, *pc);
+    if (nNode < 0)
+      return nValues;
+    // matching prefix patterns
+    for (nEntry = pIndex->aNode[nNode].nPrefixEntry; nEntry >= 0 && nValues < nMaxValues; nEntry = pIndex->aEntry[nEntry].nNextEntry)
+      anValue[nValues++] = pIndex->aEntry[nEntry].nValue;
+  }
+
+  // matching names
+  for (nEntry = pIndex->aNode[nNode].nExactEntry; nEntry >= 0 && nValues < nMaxValues; nEntry = pIndex->aEntry[nEntry].nNextEntry)
+    anValue[nValues++] = pIndex->aEntry[nEntry].nValue;
+
+  return nValues;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int FindNameIndexFirst(const NameIndex *pIndex, cpchar pszPattern)
+{
+  // get minimum value of all names matching the given name or name pattern "prefix*" (-1 = no matching name)
+  int nEntry, nValue = -1, nNode = 0;
+
+  if (!pszPattern || !*pszPattern || pIndex->nNodes == 0)
+    return -1;
+
+  int nLength = strlen(pszPattern);
+  bool bPrefix = (nLength > 1 && pszPattern[nLength - 1] == '*');
+  if (bPrefix)
+    nLength--;
+
+  for (int i = 0; i < nLength && nNode >= 0; i++)
+    nNode = GetNameIndexChild(pIndex, nNode, pszPattern[i]);
+
+  if (nNode < 0)
+    return -1;
+
+  if (bPrefix)
+    return pIndex->aNode[nNode].nMinValue;
+
+  for (nEntry = pIndex->aNode[nNode].nExactEntry; nEntry >= 0; nEntry = pIndex->aEntry[nEntry].nNextEntry)
+    if (nValue < 0 || pIndex->aEntry[nEntry].nValue < nValue)
+      nValue = pIndex->aEntry[nEntry].nValue;
+
+  return nValue;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int BuildMappingColumnIndex()
+{
+  // build index of all csv column names referenced by the mapping definition
+  // (value of entry: map index * 2 for column name in CSV_CONTENT, map index * 2 + 1 for CSV_CONTENT2)
+  int nMapIndex, nReturnCode = 0;
+  FieldMapping *pFieldMapping = aFieldMapping;
+
+  FreeNameIndex(&MappingColumnIndex);
+
+  for (nMapIndex = 0; nMapIndex < nFieldMappings && nReturnCode == 0; nMapIndex++, pFieldMapping++)
+    if (strchr("ACIMU"/*ADDFILE,CHANGE,IF,MAP,UNIQUE*/, pFieldMapping->csv.cOperation)) {
+      nReturnCode = AddNameIndexEntry(&MappingColumnIndex, pFieldMapping->csv.szContent, 2 * nMapIndex);
+      if (nReturnCode == 0)
+        nReturnCode = AddNameIndexEntry(&MappingColumnIndex, pFieldMapping->csv.szContent2, 2 * nMapIndex + 1);
+    }
+
+  if (nReturnCode != 0) {
+    strcpy(szLastError, "Not enough memory for index of csv column names");
+    puts(szLastError);
+  }
+
+  return nReturnCode;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void FreeStringDictionary(StringDictionary *pDictionary)
+{
+  free(pDictionary->anSlot);
+  free(pDictionary->aEntry);
+  memset(pDictionary, 0, sizeof(StringDictionary));
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+unsigned int GetStringHash(cpchar pszValue)
+{
+  // FNV-1a hash of zero terminated string
+  unsigned int nHash = 2166136261u;
+
+  for (const unsigned char *p = (const unsigned char*)pszValue; *p; p++)
+    nHash = (nHash ^ *p) * 16777619u;
+
+  return nHash;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int GetDictionaryId(StringDictionary *pDictionary, cpchar pszValue)
+{
+  // get id of string value (new values are added with the next free id, -1 = not enough memory)
+  // the dictionary stores only the pointer to the value, so the string must not be changed or freed
+  int i, nSlot;
+  unsigned int nHash = GetStringHash(pszValue);
+
+  if (2 * pDictionary->nEntries >= pDictionary->nSlots) {
+    // enlarge hash table (load factor below 0.5)
+    int nSlots = pDictionary->nSlots ? 2 * pDictionary->nSlots : 1024;
+    int *anSlot = (int*)malloc(nSlots * sizeof(int));
+    DictionaryEntry *aEntry = (DictionaryEntry*)realloc(pDictionary->aEntry, (nSlots / 2) * sizeof(DictionaryEntry));
+    if (!anSlot || !aEntry) {
+      free(anSlot);
+      if (aEntry)
+        pDictionary->aEntry = aEntry;
+      return -1;
+    }
+    memset(anSlot, -1, nSlots * sizeof(int));
+    for (i = 0; i < pDictionary->nEntries; i++) {
+      nSlot = (int)(aEntry[i].nHash & (nSlots - 1));
+      while (anSlot[nSlot] >= 0)
+        nSlot = (nSlot + 1) & (nSlots - 1);
+      anSlot[nSlot] = i;
+    }
+    free(pDictionary->anSlot);
+    pDictionary->anSlot = anSlot;
+    pDictionary->aEntry = aEntry;
+    pDictionary->nSlots = nSlots;
+  }
+
+  // search value (linear probing)
+  nSlot = (int)(nHash & (pDictionary->nSlots - 1));
+  while ((i = pDictionary->anSlot[nSlot]) >= 0) {
+    if (pDictionary->aEntry[i].nHash == nHash && strcmp(pDictionary->aEntry[i].pszValue, pszValue) == 0)
+      return i;
+    nSlot = (nSlot + 1) & (pDictionary->nSlots - 1);
+  }
+
+  // add new value
+  i = pDictionary->nEntries++;
+  pDictionary->aEntry[i].pszValue = pszValue;
+  pDictionary->aEntry[i].nHash = nHash;
+  pDictionary->anSlot[nSlot] = i;
+
+  return i;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int ReadFieldMappings(const char *szFileName)
+{
+  // read mapping definition
+  int i, nMapIndex, nMapIndex2, nReturnCode, nNonEmptyFields;
+  char *pColumnName = NULL;
+  const char *pszValue = NULL;
+  FieldMapping *pFieldMapping, *pFieldMapping2;
+  pchar aField[MAX_MAPPING_COLUMNS];
+  FILE *pFile = NULL;
+  //errno_t error_code;
+  char szTemp[256];
+
+  // open csv file for input in binary mode (cr/lf are not changed)
+  //error_code = fopen_s(&pFile, szFileName, "rb");
+  pFile = fopen(szFileName, "rb");
+  if (!pFile) {
+    //sprintf(szLastError, "Cannot open mapping file '%s' (error code %d)", szFileName, error_code);
+    sprintf(szLastError, "Cannot open mapping file '%s'", szFileName);
+    puts(szLastError);
+    return -2;
+  }
+
+  // get file size
+  //int fseek(FILE *stream, long offset, int whence);
+  int iReturnCode = fseek(pFile, 0, SEEK_END);
+  int nFileSize = ftell(pFile);
+
+  // allocate reading buffer
+  nFieldMappingBufferSize = nFileSize + 1 + READ_BUFFER_PADDING;
+  pFieldMappingsBuffer = (char*)malloc(nFieldMappingBufferSize);
+
+  if (!pFieldMappingsBuffer) {
+    sprintf(szLastError, "Not enough memory for reading mapping file '%s' (%d bytes)", szFileName, nFileSize);
+    puts(szLastError);
+    return -1;  // not enough free memory
+  }
+
+  // clear read buffer
+  memset(pFieldMappingsBuffer, 0, nFieldMappingBufferSize);
+
+  // initialize list of root node attributes
+  RootAttrNameValueList.nCount = 0;
+  RootAttrNameValueList.nMaxCount = MAX_NODE_ATTRIBUTES;
+  RootAttrNameValueList.aAttrNameValue = (AttributeNameValue*)malloc(RootAttrNameValueList.nMaxCount * sizeof(AttributeNameValue));
+
+  // go to start of file
+  iReturnCode = fseek(pFile, 0, SEEK_SET);
+
+  // read file content
+  int nBytesRead = fread(pFieldMappingsBuffer, nFieldMappingBufferSize, 1, pFile);
+
+  // close file
+  fclose(pFile);
+
+  // convert all line ends to LF
+  NormalizeLineEnds(pFieldMappingsBuffer);
+
+  // initialize reading position
+  char *pReadPos = pFieldMappingsBuffer;
+
+  // get header line with column names
+  char *pLine = GetNextLine(&pReadPos);
+
+  // parse header line
+  int nColumns = GetFields(pLine, ';', aField, MAX_MAPPING_COLUMNS);
+  int nCsvOpIdx = -1;
+  int nCsvContentIdx = -1;
+  int nCsvContent2Idx = -1;
+  int nCsvShortNameIdx = -1;
+  int nCsvMoIdx = -1;
+  int nCsvTypeIdx = -1;
+  int nCsvMinLenIdx = -1;
+  int nCsvPositionIdx = -1;
+  int nCsvWidthIdx = -1;
+  int nCsvMaxLenIdx = -1;
+  int nCsvMinValueIdx = -1;
+  int nCsvMaxValueIdx = -1;
+  int nCsvFormatIdx = -1;
+  int nCsvTransformIdx = -1;
+  int nCsvDefaultIdx = -1;
+  int nCsvConditionIdx = -1;
+  int nCsvMappingFormatIdx = -1;
+  int nXmlOpIdx = -1;
+  int nXmlContentIdx = -1;
+  int nXmlContent2Idx = -1;
+  int nXmlAttributeIdx = -1;
+  int nXmlShortNameIdx = -1;
+  int nXmlMoIdx = -1;
+  int nXmlTypeIdx = -1;
+  int nXmlMinLenIdx = -1;
+  int nXmlMaxLenIdx = -1;
+  int nXmlMinValueIdx = -1;
+  int nXmlMaxValueIdx = -1;
+  int nXmlFormatIdx = -1;
+  int nXmlTransformIdx = -1;
+  int nXmlDefaultIdx = -1;
+  int nXmlConditionIdx = -1;
+  int nXmlMappingFormatIdx = -1;
+  pchar szCsvOperation = NULL;
+  pchar szXmlOperation = NULL;
+  FieldMappingContext MappingContext;
+
+  // find position of mapping columns
+  for (i = 0; i < nColumns; i++) {
+    pColumnName = aField[i];
+    // search for csv columns
+    if (strcmp(pColumnName, "CSV_OP") == 0) nCsvOpIdx = i;
+    if (strcmp(pColumnName, "CSV_CONTENT") == 0) nCsvContentIdx = i;
+    if (strcmp(pColumnName, "CSV_CONTENT2") == 0) nCsvContent2Idx = i;
+    if (strcmp(pColumnName, "CSV_SHORT_NAME") == 0) nCsvShortNameIdx = i;
+    if (strcmp(pColumnName, "CSV_MO") == 0) nCsvMoIdx = i;
+    if (strcmp(pColumnName, "CSV_TYPE") == 0) nCsvTypeIdx = i;
+    if (strcmp(pColumnName, "CSV_MIN_LEN") == 0) nCsvMinLenIdx = i;
+    if (strcmp(pColumnName, "CSV_POSITION") == 0) nCsvPositionIdx = i;
+    if (strcmp(pColumnName, "CSV_WIDTH") == 0) nCsvWidthIdx = i;
+    if (strcmp(pColumnName, "CSV_MAX_LEN") == 0) nCsvMaxLenIdx = i;
+    if (strcmp(pColumnName, "CSV_MIN_VALUE") == 0) nCsvMinValueIdx = i;
+    if (strcmp(pColumnName, "CSV_MAX_VALUE") == 0) nCsvMaxValueIdx = i;
+    if (strcmp(pColumnName, "CSV_FORMAT") == 0) nCsvFormatIdx = i;
+    if (strcmp(pColumnName, "CSV_TRANSFORM") == 0) nCsvTransformIdx = i;
+    if (strcmp(pColumnName, "CSV_DEFAULT") == 0) nCsvDefaultIdx = i;
+    if (strcmp(pColumnName, "CSV_CONDITION") == 0) nCsvConditionIdx = i;
+    if (strcmp(pColumnName, "CSV_MAPPING_FORMAT") == 0) nCsvMappingFormatIdx = i;
+    // search for xml columns
+    if (strcmp(pColumnName, "XML_OP") == 0) nXmlOpIdx = i;
+    if (strcmp(pColumnName, "XML_CONTENT") == 0) nXmlContentIdx = i;
+    if (strcmp(pColumnName, "XML_CONTENT2") == 0) nXmlContent2Idx = i;
+    if (strcmp(pColumnName, "XML_ATTRIBUTE") == 0) nXmlAttributeIdx = i;
+    if (strcmp(pColumnName, "XML_SHORT_NAME") == 0) nXmlShortNameIdx = i;
+    if (strcmp(pColumnName, "XML_MO") == 0) nXmlMoIdx = i;
+    if (strcmp(pColumnName, "XML_TYPE") == 0) nXmlTypeIdx = i;
+    if (strcmp(pColumnName, "XML_MIN_LEN") == 0) nXmlMinLenIdx = i;
+    if (strcmp(pColumnName, "XML_MAX_LEN") == 0) nXmlMaxLenIdx = i;
+    if (strcmp(pColumnName, "XML_MIN_VALUE") == 0) nXmlMinValueIdx = i;
+    if (strcmp(pColumnName, "XML_MAX_VALUE") == 0) nXmlMaxValueIdx = i;
+    if (strcmp(pColumnName, "XML_FORMAT") == 0) nXmlFormatIdx = i;
+    if (strcmp(pColumnName, "XML_TRANSFORM") == 0) nXmlTransformIdx = i;
+    if (strcmp(pColumnName, "XML_DEFAULT") == 0) nXmlDefaultIdx = i;
+    if (strcmp(pColumnName, "XML_CONDITION") == 0) nXmlConditionIdx = i;
+    if (strcmp(pColumnName, "XML_MAPPING_FORMAT") == 0) nXmlMappingFormatIdx = i;
+  }
+
+  if (nCsvOpIdx < 0 || nCsvContentIdx < 0 || nCsvTypeIdx < 0 || nXmlOpIdx < 0 || nXmlContentIdx < 0)
+    return -2;  // missing mandatory columns in mapping file
+
+  pFieldMapping = aFieldMapping;
+
+  // load field mapping definitions into mapping array
+  while (pLine = GetNextLine(&pReadPos)) {
+    nColumns = GetFields(pLine, ';', aField, MAX_MAPPING_COLUMNS);
+
+    nNonEmptyFields = 0;
+    for (i = 0; i < nColumns; i++)
+      if (strlen(aField[i]) > 0)
+        nNonEmptyFields++;
+
+    // line with real content ?
+    if (*pLine != '#' /*Comment*/ && nNonEmptyFields >= 3 && nFieldMappings < MAX_FIELD_MAPPINGS) {
+      nMapIndex = nFieldMappings;
+      MappingContext.aField = aField;
+      MappingContext.nFields = nColumns;
+      MappingContext.nMapIndex = nMapIndex;
+      MappingContext.pFieldMapping = pFieldMapping;
+
+      //pFieldMapping->csv = EmptyFieldDefinition;
+      MappingContext.pFieldDefinition = &pFieldMapping->csv;
+      pFieldMapping->csv.cOperation = LoadCharMappingField(&MappingContext, "CSV_OP", nCsvOpIdx, true, ",FIX,VAR,MAP,NOP,CHANGE,UNIQUE,IF,ADDFILE,", 'M');
+      pFieldMapping->csv.szContent = LoadTextMappingField(&MappingContext, "CSV_CONTENT", nCsvContentIdx, NULL);
+      pFieldMapping->csv.szContent2 = LoadTextMappingField(&MappingContext, "CSV_CONTENT2", nCsvContent2Idx, NULL);
+      pFieldMapping->csv.szAttribute = NULL; // not used at the moment
+      pFieldMapping->csv.szShortName = LoadTextMappingField(&MappingContext, "CSV_SHORT_NAME", nCsvShortNameIdx, NULL);
+      pFieldMapping->csv.bMandatory = LoadBoolMappingField(&MappingContext, "CSV_MO", nCsvMoIdx, "M", "O", false);
+      pFieldMapping->csv.cType = LoadCharMappingField(&MappingContext, "CSV_TYPE", nCsvTypeIdx, (pFieldMapping->csv.cOperation != 'N'), ",BOOLEAN,DATE,DATETIME,INTEGER,NUMBER,TEXT,", 'T');
+      pFieldMapping->csv.nMinLen = LoadIntMappingField(&MappingContext, "CSV_MIN_LEN", nCsvMinLenIdx, 0);
+      pFieldMapping->csv.nMaxLen = LoadIntMappingField(&MappingContext, "CSV_MAX_LEN", nCsvMaxLenIdx, -1);
+      pFieldMapping->csv.nPosition = LoadIntMappingField(&MappingContext, "CSV_POSITION", nCsvPositionIdx, 0);
+      pFieldMapping->csv.nWidth = LoadIntMappingField(&MappingContext, "CSV_WIDTH", nCsvWidthIdx, 0);
+      pFieldMapping->csv.szMinValue = LoadTextMappingField(&MappingContext, "CSV_MIN_VALUE", nCsvMinValueIdx, NULL);
+      pFieldMapping->csv.szMaxValue = LoadTextMappingField(&MappingContext, "CSV_MAX_VALUE", nCsvMaxValueIdx, NULL);
+      pFieldMapping->csv.szFormat = LoadTextMappingField(&MappingContext, "CSV_FORMAT", nCsvFormatIdx, NULL);
+      pFieldMapping->csv.szTransform = LoadTextMappingField(&MappingContext, "CSV_TRANSFORM", nCsvTransformIdx, NULL);
+      pFieldMapping->csv.szDefault = LoadTextMappingField(&MappingContext, "CSV_DEFAULT", nCsvDefaultIdx, NULL);
+      pFieldMapping->csv.szCondition = LoadTextMappingField(&MappingContext, "CSV_CONDITION", nCsvConditionIdx, NULL);
+      pFieldMapping->csv.szMappingFormat = LoadTextMappingField(&MappingContext, "CSV_MAPPING_FORMAT", nCsvMappingFormatIdx, NULL);
+      LoadMinMaxValues(&MappingContext, "CSV_MIN_VALUE", "CSV_MAX_VALUE");
+
+      //pFieldMapping->xml = EmptyFieldDefinition;
+      MappingContext.pFieldDefinition = &pFieldMapping->xml;
+      pFieldMapping->xml.cOperation = LoadCharMappingField(&MappingContext, "XML_OP", nXmlOpIdx, true, ",FIX,VAR,MAP,LOOP,IF,ROOT,", 0);
+      pFieldMapping->xml.szContent = LoadTextMappingField(&MappingContext, "XML_CONTENT", nXmlContentIdx, NULL);
+      pFieldMapping->xml.szContent2 = LoadTextMappingField(&MappingContext, "XML_CONTENT2", nXmlContent2Idx, NULL);
+      pFieldMapping->xml.szAttribute = LoadTextMappingField(&MappingContext, "XML_ATTRIBUTE", nXmlAttributeIdx, NULL);
+      pFieldMapping->xml.szShortName = LoadTextMappingField(&MappingContext, "XML_SHORT_NAME", nXmlShortNameIdx, NULL);
+      pFieldMapping->xml.bMandatory = LoadBoolMappingField(&MappingContext, "XML_MO", nXmlMoIdx, "M", "O", pFieldMapping->csv.bMandatory);
+      pFieldMapping->xml.bAddEmptyNodes = false;
+      pFieldMapping->xml.cType = LoadCharMappingField(&MappingContext, "XML_TYPE", nXmlTypeIdx, false, ",BOOLEAN,DATE,DATETIME,INTEGER,NUMBER,TEXT,", pFieldMapping->csv.cType);
+      pFieldMapping->xml.nMinLen = LoadIntMappingField(&MappingContext, "XML_MIN_LEN", nXmlMinLenIdx, pFieldMapping->csv.nMinLen);
+      pFieldMapping->xml.nMaxLen = LoadIntMappingField(&MappingContext, "XML_MAX_LEN", nXmlMaxLenIdx, pFieldMapping->csv.nMaxLen);
+      pFieldMapping->xml.szMinValue = LoadTextMappingField(&MappingContext, "XML_MIN_VALUE", nXmlMinValueIdx, NULL);
+      pFieldMapping->xml.szMaxValue = LoadTextMappingField(&MappingContext, "XML_MAX_VALUE", nXmlMaxValueIdx, NULL);
+      pFieldMapping->xml.szFormat = LoadTextMappingField(&MappingContext, "XML_FORMAT", nXmlFormatIdx, NULL);
+      pFieldMapping->xml.szTransform = LoadTextMappingField(&MappingContext, "XML_TRANSFORM", nXmlTransformIdx, NULL);
+      pFieldMapping->xml.szDefault = LoadTextMappingField(&MappingContext, "XML_DEFAULT", nXmlDefaultIdx, NULL);
+      pFieldMapping->xml.szCondition = LoadTextMappingField(&MappingContext, "XML_CONDITION", nXmlConditionIdx, NULL);
+      pFieldMapping->xml.Condition.pComplexCondition = NULL;
+      pFieldMapping->xml.Condition.pSimpleCondition = NULL;
+      pFieldMapping->xml.szMappingFormat = LoadTextMappingField(&MappingContext, "XML_MAPPING_FORMAT", nXmlMappingFormatIdx, NULL);
+
+      if (pFieldMapping->csv.cOperation == 'N'/*NOP*/ && pFieldMapping->xml.cOperation == 'R'/*ROOT*/) {
+        if (IsEmptyString(pFieldMapping->xml.szContent)) {
+          sprintf(szLastError, "Missing mandatory content");
+          LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->xml.cOperation), "XML_CONTENT", szLastError);
+        }
+        else {
+          if (IsEmptyString(pFieldMapping->xml.szAttribute))
+            mystrncpy(szRootNodeName, pFieldMapping->xml.szContent, MAX_NODE_NAME_SIZE);
+          else
+            SimpleAddAttributeToList(&RootAttrNameValueList, pFieldMapping->xml.szAttribute, pFieldMapping->xml.szContent);
+        }
+      }
+      else {
+        // add new mapping
+        pszValue = aField[nXmlTypeIdx];
+        if (strcmp(pszValue, "DATE") == 0 && strlen(pFieldMapping->xml.szFormat) < 10)
+          pFieldMapping->xml.szFormat = szXmlDateFormat;
+        if (strcmp(pszValue, "DATETIME") == 0 && strlen(pFieldMapping->xml.szFormat) < 19)
+          pFieldMapping->xml.szFormat = szXmlTimestampFormat;
+        LoadMinMaxValues(&MappingContext, "XML_MIN_VALUE", "XML_MAX_VALUE");
+
+        // csv file indices
+        pFieldMapping->nCsvFileIndex = 0;
+        pFieldMapping->nCsvFileIndex2 = 0;
+        if (strchr("FV", pFieldMapping->csv.cOperation) == NULL) {
+          CheckForFileIndex((pchar*)&pFieldMapping->csv.szContent, &(pFieldMapping->nCsvFileIndex));
+          CheckForFileIndex((pchar*)&pFieldMapping->csv.szContent2, &(pFieldMapping->nCsvFileIndex2));
+        }
+
+        if (pFieldMapping->csv.cOperation != 'F' && IsEmptyString(pFieldMapping->csv.szContent)) {
+          sprintf(szLastError, "Missing mandatory content");
+          LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->csv.cOperation), "CSV_CONTENT", szLastError);
+        }
+
+        if (pFieldMapping->xml.cOperation != 'F' && IsEmptyString(pFieldMapping->xml.szContent)) {
+          sprintf(szLastError, "Missing mandatory content");
+          LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->xml.cOperation), "XML_CONTENT", szLastError);
+        }
+
+        if (pFieldMapping->csv.nPosition > 0 && pFieldMapping->csv.nWidth <= 0) {
+          sprintf(szLastError, "Missing width of fixed width field at position %d", pFieldMapping->csv.nPosition);
+          LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->csv.cOperation), "CSV_WIDTH", szLastError);
+        }
+
+        // check combination of mapping operations (csv/xml)
+        sprintf(szTemp, "%c%c", pFieldMapping->csv.cOperation, pFieldMapping->xml.cOperation);
+        if (!CheckRegex(szTemp, ",AM,FM,MF,VM,MV,MM,CL,UL,II,NR,")) {
+          sprintf(szLastError, "Invalid combination of csv and xml operation '%s'-'%s'", GetOperationLongName(pFieldMapping->csv.cOperation), GetOperationLongName(pFieldMapping->xml.cOperation));
+          LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->xml.cOperation), "XML_CONTENT", szLastError);
+        }
 
         // use csv format for xml field if type is equal and xml format not specified
         if (pFieldMapping->csv.cOperation == 'M' && pFieldMapping->xml.cOperation == 'M' && IsEmptyString(pFieldMapping->xml.szFormat) &&
             strchr("BT", pFieldMapping->xml.cType) && pFieldMapping->csv.cType == pFieldMapping->xml.cType)
           pFieldMapping->xml.szFormat = pFieldMapping->csv.szFormat;
 
-        // check syntax of xml condition
-        if (!IsEmptyString(pFieldMapping->xml.szCondition)) {
-          nReturnCode = ParseCondition(pFieldMapping->xml.szCondition, &pFieldMapping->xml.Condition);
-          if (nReturnCode != 0) {
-            LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->xml.cOperation), "XML_CONDITION", szLastError);
+        // compile csv and xml format once (CheckRegex is used for formats not compiled)
+        CompileFormat(&pFieldMapping->csv.Format, pFieldMapping->csv.szFormat);
+        CompileFormat(&pFieldMapping->xml.Format, pFieldMapping->xml.szFormat);
+        if (pFieldMapping->csv.cType == 'D'/*DATE*/)
+          CompileDateCodec(&pFieldMapping->csv.DateFormat, pFieldMapping->csv.szFormat);
+        if (pFieldMapping->xml.cType == 'D'/*DATE*/)
+          CompileDateCodec(&pFieldMapping->xml.DateFormat, pFieldMapping->xml.szFormat);
+        SelectValueConverters(pFieldMapping);
+
+        // compile csv and xml transform (applied before checking and after converting the value)
+        if (CompileValueTransform(pFieldMapping->csv.szTransform, &pFieldMapping->csv.Transform) != 0)
+          LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->csv.cOperation), "CSV_TRANSFORM", szLastError);
+        if (CompileValueTransform(pFieldMapping->xml.szTransform, &pFieldMapping->xml.Transform) != 0)
+          LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->xml.cOperation), "XML_TRANSFORM", szLastError);
+        InternConstantXmlValues(pFieldMapping);
+
+        // check syntax of xml condition
+        if (!IsEmptyString(pFieldMapping->xml.szCondition)) {
+          nReturnCode = ParseCondition(pFieldMapping->xml.szCondition, &pFieldMapping->xml.Condition);
+          if (nReturnCode != 0) {
+            LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->xml.cOperation), "XML_CONDITION", szLastError);
+          }
+        }
+
+        // parse csv condition (column indices are resolved after reading the csv header line)
+        pFieldMapping->csv.Condition.pComplexCondition = NULL;
+        pFieldMapping->csv.Condition.pSimpleCondition = NULL;
+        if (!IsEmptyString(pFieldMapping->csv.szCondition) && stricmp(pFieldMapping->csv.szCondition, "contentisvalid()") != 0) {
+          pchar pszCondition = (pchar)MyGetMemory(strlen(pFieldMapping->csv.szCondition) + 1);
+          if (pszCondition) {
+            strcpy(pszCondition, pFieldMapping->csv.szCondition);
+            nReturnCode = ParseCsvCondition(pszCondition, &pFieldMapping->csv.Condition);
+            if (nReturnCode != 0)
+              LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->csv.cOperation), "CSV_CONDITION", szLastError);
+          }
+        }
+
+        // check syntax of mapping format columns
+        // Samples: "'PRAEFIX-'*", "*'-POSTFIX'"
+        if (!IsValidMappingFormat(pFieldMapping->csv.szMappingFormat)) {
+          sprintf(szLastError, "Invalid csv mapping format \"%s\" (valid samples: \"'PRAEFIX-'*\", \"*'-POSTFIX'\")", pFieldMapping->csv.szMappingFormat);
+          LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->csv.cOperation), "CSV_MAPPING_FORMAT", szLastError);
+          pFieldMapping->csv.szMappingFormat = szEmptyString;
+        }
+        if (!IsValidMappingFormat(pFieldMapping->xml.szMappingFormat)) {
+          sprintf(szLastError, "Invalid xml mapping format \"%s\" (valid samples: \"'PRAEFIX-'*\", \"*'-POSTFIX'\")", pFieldMapping->xml.szMappingFormat);
+          LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->xml.cOperation), "XML_MAPPING_FORMAT", szLastError);
+          pFieldMapping->xml.szMappingFormat = szEmptyString;
+        }
+
+        pFieldMapping->nCsvIndex = -1;
+        pFieldMapping->nCsvIndex2 = -1;
+        pFieldMapping->nSourceMapIndex = -1;
+        pFieldMapping++;
+        nFieldMappings++;
+      }
+    }
+  }
+
+  CompileFormat(&DefaultBooleanMatcher, szDefaultBooleanFormat);
+
+  // search for field content mapping of source columns
+  for (nMapIndex = 0, pFieldMapping = aFieldMapping; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++)
+    if (strchr("CIU"/*CHANGE,IF,UNIQUE*/, pFieldMapping->csv.cOperation)) {
+      // search for content mapping of source column
+      for (nMapIndex2 = 0, pFieldMapping2 = aFieldMapping; nMapIndex2 < nFieldMappings; nMapIndex2++, pFieldMapping2++)
+        if (pFieldMapping2->csv.cOperation == 'M' && pFieldMapping2->xml.cOperation == 'M' && strcmp(pFieldMapping->csv.szContent, pFieldMapping2->csv.szContent) == 0) {
+          pFieldMapping->nSourceMapIndex = nMapIndex2;
+          nMapIndex2 = nFieldMappings;
+        }
+    }
+
+  // build index of referenced csv column names (used for header line detection)
+  if (BuildMappingColumnIndex() != 0)
+    return -1;
+
+  if (nFieldMappings == 0) {
+    sprintf(szLastError, "No field mappings found in '%s'", szFileName);
+    puts(szLastError);
+  }
+
+  return nFieldMappings;
+}
+// end of function "ReadFieldMappings"
+
+//--------------------------------------------------------------------------------------------------------
+
+void FreeCsvFileBuffers()
+{
+  LinkedCsvFile *pLinkedCsvFile = aLinkedCsvFile;
+
+  for (int i = 0; i < nLinkedCsvFiles; i++) {
+    if (pLinkedCsvFile->pDataBuffer != NULL) {
+      free(pLinkedCsvFile->pDataBuffer);
+      pLinkedCsvFile->pDataBuffer = NULL;
+    }
+    if (pLinkedCsvFile->aDataFields != NULL) {
+      free(pLinkedCsvFile->aDataFields);
+      pLinkedCsvFile->aDataFields = NULL;
+    }
+    FreeNameIndex(&pLinkedCsvFile->HeaderIndex);
+    if (pLinkedCsvFile->aTypedColumn != NULL) {
+      for (int j = 0; j < pLinkedCsvFile->nColumns; j++) {
+        free(pLinkedCsvFile->aTypedColumn[j].aValue);
+        free(pLinkedCsvFile->aTypedColumn[j].abValid);
+        free(pLinkedCsvFile->aTypedColumn[j].abInRange);
+      }
+      free(pLinkedCsvFile->aTypedColumn);
+      pLinkedCsvFile->aTypedColumn = NULL;
+    }
+    if (pLinkedCsvFile->pFieldBuffer != NULL) {
+      free(pLinkedCsvFile->pFieldBuffer);
+      pLinkedCsvFile->pFieldBuffer = NULL;
+    }
+    if (pLinkedCsvFile->aInternedColumn != NULL) {
+      for (int j = 0; j < pLinkedCsvFile->nColumns; j++) {
+        free(pLinkedCsvFile->aInternedColumn[j].anValueId);
+        free(pLinkedCsvFile->aInternedColumn[j].anFirstLine);
+      }
+      free(pLinkedCsvFile->aInternedColumn);
+      pLinkedCsvFile->aInternedColumn = NULL;
+    }
+    pLinkedCsvFile++;
+  }
+
+  // dictionary references values of the freed read buffers
+  FreeStringDictionary(&CsvValueDictionary);
+
+  // validation results and converted values refer to lines of the csv files
+  for (int i = 0; i < nFieldMappings; i++) {
+    if (aFieldMapping[i].anCellError != NULL) {
+      free(aFieldMapping[i].anCellError);
+      aFieldMapping[i].anCellError = NULL;
+    }
+    free(aFieldMapping[i].Converted.anOffset);
+    free(aFieldMapping[i].Converted.pValues);
+    memset(&aFieldMapping[i].Converted, 0, sizeof(ConvertedColumn));
+  }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+bool MatchingColumnName(cpchar pszColumnName, cpchar pszSearchColumnName)
+{
+  // Compares given csv column name with search pattern from mapping definition
+  // If search pattern contains asterics '*' at the end, then rest of the column name is ignored
+  // Sample: column name "3_Portfolio_name" is matching "3_*"
+  //
+  bool bMatch;
+
+  if (!pszColumnName || !*pszColumnName || !pszSearchColumnName || !*pszSearchColumnName)
+    return false;
+
+  int nPos = strlen(pszSearchColumnName) - 1;
+
+  if (nPos > 0 && pszSearchColumnName[nPos] == '*')
+    bMatch = (strnicmp(pszColumnName, pszSearchColumnName, nPos) == 0);
+  else
+    bMatch = (stricmp(pszColumnName, pszSearchColumnName) == 0);
+
+  return bMatch;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void ResetFieldIndices()
+{
+  // reset field indices
+  FieldMapping *pFieldMapping = aFieldMapping;
+	for (int i = 0; i < nFieldMappings; i++, pFieldMapping++)  {
+    pFieldMapping->nCsvIndex = -1;
+    pFieldMapping->nCsvIndex2 = -1;
+  }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int GetValidUtf8Length(cpchar pBuffer, int nLength)
+{
+  // return length of the valid utf-8 prefix of the buffer (nLength if the whole buffer is valid)
+  const unsigned char *pStart = (const unsigned char*)pBuffer;
+  const unsigned char *p = pStart, *pEnd = pStart + nLength;
+  unsigned int nCodePoint, nMinCodePoint;
+  int i, nFollowBytes;
+
+  while (p < pEnd) {
+#ifdef USE_SSE2
+    // skip blocks of 16 ascii characters at once
+    while (pEnd - p >= 16) {
+      int nMask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)p));
+      if (nMask) {
+        while (!(nMask & 1)) {
+          nMask >>= 1;
+          p++;
+        }
+        break;
+      }
+      p += 16;
+    }
+    if (p >= pEnd)
+      break;
+#endif
+    unsigned char c = *p;
+    if (c < 0x80) {
+      p++;
+      continue;
+    }
+
+    // multi byte sequence
+    if ((c & 0xE0) == 0xC0) {
+      nFollowBytes = 1;
+      nCodePoint = c & 0x1F;
+      nMinCodePoint = 0x80;
+    }
+    else if ((c & 0xF0) == 0xE0) {
+      nFollowBytes = 2;
+      nCodePoint = c & 0x0F;
+      nMinCodePoint = 0x800;
+    }
+    else if ((c & 0xF8) == 0xF0) {
+      nFollowBytes = 3;
+      nCodePoint = c & 0x07;
+      nMinCodePoint = 0x10000;
+    }
+    else
+      break;  // invalid start byte
+
+    if (pEnd - p <= nFollowBytes)
+      break;  // truncated sequence
+
+    for (i = 1; i <= nFollowBytes; i++) {
+      if ((p[i] & 0xC0) != 0x80)
+        break;
+      nCodePoint = (nCodePoint << 6) | (p[i] & 0x3F);
+    }
+
+    // reject invalid continuation bytes, overlong encodings, surrogates and values beyond unicode range
+    if (i <= nFollowBytes || nCodePoint < nMinCodePoint || nCodePoint > 0x10FFFF || (nCodePoint >= 0xD800 && nCodePoint <= 0xDFFF))
+      break;
+
+    p += nFollowBytes + 1;
+  }
+
+  return (int)(p - pStart);
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+pchar AppendUtf8Char(pchar pOutput, unsigned int nCodePoint)
+{
+  // write code point as utf-8 sequence and return position after it
+  if (nCodePoint < 0x80)
+    *pOutput++ = (char)nCodePoint;
+  else if (nCodePoint < 0x800) {
+    *pOutput++ = (char)(0xC0 | (nCodePoint >> 6));
+    *pOutput++ = (char)(0x80 | (nCodePoint & 0x3F));
+  }
+  else if (nCodePoint < 0x10000) {
+    *pOutput++ = (char)(0xE0 | (nCodePoint >> 12));
+    *pOutput++ = (char)(0x80 | ((nCodePoint >> 6) & 0x3F));
+    *pOutput++ = (char)(0x80 | (nCodePoint & 0x3F));
+  }
+  else {
+    *pOutput++ = (char)(0xF0 | (nCodePoint >> 18));
+    *pOutput++ = (char)(0x80 | ((nCodePoint >> 12) & 0x3F));
+    *pOutput++ = (char)(0x80 | ((nCodePoint >> 6) & 0x3F));
+    *pOutput++ = (char)(0x80 | (nCodePoint & 0x3F));
+  }
+
+  return pOutput;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int TranscodeCsvBuffer(LinkedCsvFile *pCsvFile, int nLength, InputEncoding encoding, int nUtf16Order)
+{
+  // convert content of read buffer to utf-8 (single byte encodings or utf-16 with byte order 1 = LE, 2 = BE)
+  // windows-1252 code points of the characters 0x80 - 0x9F (undefined positions are mapped like latin-1)
+  static const unsigned short anCp1252[32] = {
+    0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021, 0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+    0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014, 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+  };
+  const unsigned char *p = (const unsigned char*)pCsvFile->pDataBuffer;
+  const unsigned char *pEnd = p + nLength;
+  unsigned int nCodePoint, nLowSurrogate;
+
+  // every input byte results in at most 3 output bytes
+  int nBufferSize = 3 * nLength + 1 + READ_BUFFER_PADDING;
+  pchar pBuffer = (pchar)malloc(nBufferSize);
+  if (!pBuffer) {
+    sprintf(szLastError, "Not enough memory for converting input file '%s' (%d bytes)", pCsvFile->szFileName, nBufferSize);
+    puts(szLastError);
+    return -1;  // not enough free memory
+  }
+
+  pchar pOutput = pBuffer;
+
+  if (nUtf16Order) {
+    while (pEnd - p >= 2) {
+      nCodePoint = (nUtf16Order == 1) ? (p[0] | (p[1] << 8)) : ((p[0] << 8) | p[1]);
+      p += 2;
+      if (nCodePoint >= 0xD800 && nCodePoint <= 0xDBFF && pEnd - p >= 2) {
+        nLowSurrogate = (nUtf16Order == 1) ? (p[0] | (p[1] << 8)) : ((p[0] << 8) | p[1]);
+        if (nLowSurrogate >= 0xDC00 && nLowSurrogate <= 0xDFFF) {
+          nCodePoint = 0x10000 + ((nCodePoint - 0xD800) << 10) + (nLowSurrogate - 0xDC00);
+          p += 2;
+        }
+      }
+      if (nCodePoint >= 0xD800 && nCodePoint <= 0xDFFF)
+        nCodePoint = 0xFFFD;  // unpaired surrogate
+      pOutput = AppendUtf8Char(pOutput, nCodePoint);
+    }
+  }
+  else {
+    while (p < pEnd) {
+#ifdef USE_SSE2
+      // copy blocks of 16 ascii characters at once
+      while (pEnd - p >= 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)p);
+        if (_mm_movemask_epi8(block))
+          break;
+        _mm_storeu_si128((__m128i*)pOutput, block);
+        p += 16;
+        pOutput += 16;
+      }
+      if (p >= pEnd)
+        break;
+#endif
+      nCodePoint = *p++;
+      if (nCodePoint >= 0x80 && nCodePoint < 0xA0 && encoding != LATIN1_ENCODING)
+        nCodePoint = anCp1252[nCodePoint - 0x80];
+      pOutput = AppendUtf8Char(pOutput, nCodePoint);
+    }
+  }
+  memset(pOutput, 0, READ_BUFFER_PADDING + 1);
+
+  // replace read buffer
+  free(pCsvFile->pDataBuffer);
+  pCsvFile->pDataBuffer = pBuffer;
+  pCsvFile->nDataBufferSize = nBufferSize;
+
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int DecodeCsvBuffer(LinkedCsvFile *pCsvFile, int nLength)
+{
+  // make sure the content of the read buffer is utf-8 encoded (byte order mark is removed)
+  unsigned char *p = (unsigned char*)pCsvFile->pDataBuffer;
+  bool bUtf8Bom = false;
+
+  // check byte order mark
+  if (nLength >= 3 && p[0] == 0xEF && p[1] == 0xBB && p[2] == 0xBF) {
+    memmove(p, p + 3, nLength - 3 + 1);
+    nLength -= 3;
+    bUtf8Bom = true;
+  }
+  else if (nLength >= 2 && ((p[0] == 0xFF && p[1] == 0xFE) || (p[0] == 0xFE && p[1] == 0xFF))) {
+    int nUtf16Order = (p[0] == 0xFF) ? 1 : 2;
+    memmove(p, p + 2, nLength - 2 + 1);
+    if (bTrace)
+      printf("Input file '%s' is UTF-16 encoded\n", pCsvFile->szFileName);
+    return TranscodeCsvBuffer(pCsvFile, nLength - 2, inputEncoding, nUtf16Order);
+  }
+
+  // single byte encoding selected by parameter
+  if (!bUtf8Bom && (inputEncoding == LATIN1_ENCODING || inputEncoding == CP1252_ENCODING))
+    return TranscodeCsvBuffer(pCsvFile, nLength, inputEncoding, 0);
+
+  // validate utf-8 content
+  int nValidLength = GetValidUtf8Length(pCsvFile->pDataBuffer, nLength);
+  if (nValidLength == nLength)
+    return 0;
+
+  if (inputEncoding == AUTO_ENCODING && !bUtf8Bom) {
+    // no valid utf-8 => input is assumed to be windows-1252 encoded
+    printf("Input file '%s' is not UTF-8 encoded, reading it as Windows-1252\n", pCsvFile->szFileName);
+    return TranscodeCsvBuffer(pCsvFile, nLength, CP1252_ENCODING, 0);
+  }
+
+  // determine line number of invalid byte sequence
+  int nLine = 1;
+  for (cpchar pPos = pCsvFile->pDataBuffer; (pPos = (cpchar)memchr(pPos, '\n', pCsvFile->pDataBuffer + nValidLength - pPos)) != NULL; pPos++)
+    nLine++;
+
+  sprintf(szLastError, "Invalid UTF-8 byte sequence in line %d of input file '%s'", nLine, pCsvFile->szFileName);
+  puts(szLastError);
+  return -3;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int BuildFixedWidthFields(int nCsvFileIndex, pchar *aField)
+{
+  // collect fixed width fields of the csv file from the mapping definition (CSV_POSITION, CSV_WIDTH) and
+  // return their column names in aField (order of first definition, 0 = delimited csv file with header line)
+  int i, nMapIndex, nFields = 0;
+  LinkedCsvFile *pCsvFile = aLinkedCsvFile + nCsvFileIndex;
+  CPFieldMapping pFieldMapping = aFieldMapping;
+
+  if (convDir == CSV2XML) {
+    for (nMapIndex = 0; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++) {
+      if (!strchr("CIMU"/*CHANGE,IF,MAP,UNIQUE*/, pFieldMapping->csv.cOperation) || pFieldMapping->nCsvFileIndex != nCsvFileIndex)
+        continue;
+      if (pFieldMapping->csv.nPosition <= 0 || pFieldMapping->csv.nWidth <= 0 || IsEmptyString(pFieldMapping->csv.szContent))
+        continue;
+
+      // first definition of the column name is used
+      for (i = 0; i < nFields && stricmp(aField[i], pFieldMapping->csv.szContent) != 0; i++)
+        ;
+      if (i < nFields || nFields >= MAX_CSV_COLUMNS)
+        continue;
+
+      pCsvFile->aFixedWidthField[nFields].nOffset = pFieldMapping->csv.nPosition - 1;
+      pCsvFile->aFixedWidthField[nFields].nWidth = pFieldMapping->csv.nWidth;
+      aField[nFields++] = (pchar)pFieldMapping->csv.szContent;
+    }
+  }
+
+  pCsvFile->nFixedWidthFields = nFields;
+
+  return nFields;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+bool IsAsciiText(cpchar pszText)
+{
+  // check whether the text contains only 7 bit characters (positions of characters equal byte offsets)
+  const unsigned char *p = (const unsigned char*)pszText;
+
+#ifdef USE_SSE2
+  // check blocks of 16 characters at once (the read buffer is padded with zero bytes)
+  __m128i vZero = _mm_setzero_si128();
+  for (;;) {
+    __m128i block = _mm_loadu_si128((const __m128i*)p);
+    if (_mm_movemask_epi8(block))
+      return false;
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(block, vZero)))
+      return true;
+    p += 16;
+  }
+#else
+  for (; *p; p++)
+    if (*p >= 0x80)
+      return false;
+
+  return true;
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+cpchar SkipUtf8Characters(cpchar pPos, int nCharacters)
+{
+  // skip given number of utf-8 encoded characters (stops at the end of the line)
+  for (; nCharacters > 0 && *pPos; nCharacters--) {
+    pPos++;
+    while ((*pPos & 0xC0) == 0x80)
+      pPos++;
+  }
+
+  return pPos;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+bool SliceFixedWidthLine(LinkedCsvFile *pCsvFile, cpchar pLine, bool bAsciiText, pchar *aField, pchar *ppFieldBuffer, int nKeyColumnIndex)
+{
+  // copy the fixed width fields of the line without leading and trailing spaces to the field buffer
+  // (same acceptance rules as IsAcceptedCsvLine: comment prefix, minimum non-empty fields and key column)
+  int i, nLength, nNonEmptyFields = 0;
+  int nFields = pCsvFile->nFixedWidthFields;
+  pchar pBuffer = *ppFieldBuffer;
+  cpchar pStart, pEnd;
+  FixedWidthField const *pField = pCsvFile->aFixedWidthField;
+
+  // comment line ?
+  if (*szCommentPrefix && strncmp(pLine, szCommentPrefix, strlen(szCommentPrefix)) == 0)
+    return false;
+
+  nLength = bAsciiText ? strlen(pLine) : 0;
+
+  for (i = 0; i < nFields; i++, pField++) {
+    // field boundaries (character positions are byte offsets in 7 bit files)
+    if (bAsciiText) {
+      pStart = pLine + ((pField->nOffset < nLength) ? pField->nOffset : nLength);
+      pEnd = pLine + ((pField->nOffset + pField->nWidth < nLength) ? pField->nOffset + pField->nWidth : nLength);
+    }
+    else {
+      pStart = SkipUtf8Characters(pLine, pField->nOffset);
+      pEnd = SkipUtf8Characters(pStart, pField->nWidth);
+    }
+
+    // remove padding
+    while (pStart < pEnd && (*pStart == ' ' || *pStart == '\t'))
+      pStart++;
+    while (pEnd > pStart && (pEnd[-1] == ' ' || pEnd[-1] == '\t'))
+      pEnd--;
+
+    if (pStart == pEnd)
+      aField[i] = (pchar)szEmptyString;
+    else {
+      aField[i] = pBuffer;
+      memcpy(pBuffer, pStart, pEnd - pStart);
+      pBuffer += pEnd - pStart;
+      *pBuffer++ = '\0';
+      nNonEmptyFields++;
+    }
+  }
+
+  if (nNonEmptyFields == 0 || nNonEmptyFields < ((nMinNonEmptyColumns < nFields) ? nMinNonEmptyColumns : nFields))
+    return false;  // content of line is not used, field buffer is reused for the next line
+  if (nKeyColumnIndex >= 0 && nKeyColumnIndex < nFields && !*aField[nKeyColumnIndex])
+    return false;
+
+  *ppFieldBuffer = pBuffer;
+
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int ReadCsvData(int nCsvFileIndex)
+{
+  // read and parse content of csv file
+  int i, nColumnIndex, nMapIndex, nColumns, nFound, nMatches, nKeyColumnIndex = -1;
+  int anMatch[2 * MAX_FIELD_MAPPINGS];
+  bool abMappingFound[MAX_FIELD_MAPPINGS];
+  LinkedCsvFile *pCsvFile = aLinkedCsvFile + nCsvFileIndex;
+  char *pColumnName = NULL;
+  char szErrorMessage[MAX_ERROR_MESSAGE_SIZE];
+  char szTempHeader[MAX_HEADER_SIZE];
+  cpchar szIgnoreXPath = NULL;
+  pchar aField[MAX_CSV_COLUMNS];
+  FieldMapping *pFieldMapping = NULL;
+  FILE *pFile = NULL;
+  //errno_t error_code;
+  bool bCheck, bStoreLine;
+
+  // initialize buffer pointers and number of columns and csv data lines
+  pCsvFile->pDataBuffer = NULL;
+  pCsvFile->aDataFields = NULL;
+  pCsvFile->aTypedColumn = NULL;
+  pCsvFile->aInternedColumn = NULL;
+  pCsvFile->pFieldBuffer = NULL;
+  pCsvFile->nFixedWidthFields = 0;
+  pCsvFile->nColumns = 0;
+  pCsvFile->nDataLines = 0;
+  pCsvFile->nRealDataLines = 0;
+  pCsvFile->nFilteredDataLines = 0;
+
+  // open csv file for input in binary mode (cr/lf are not changed)
+  //error_code = fopen_s(&pFile, pCsvFile->szFileName, "rb");
+  pFile = fopen(pCsvFile->szFileName, "rb");
+  if (!pFile) {
+    //sprintf(szLastError, "Cannot open input file '%s' (error code %d)", pCsvFile->szFileName, error_code);
+    sprintf(szLastError, "Cannot open input file '%s'", pCsvFile->szFileName);
+    puts(szLastError);
+    return -2;
+  }
+
+  // get file size
+  //int fseek(FILE *stream, long offset, int whence);
+  int iReturnCode = fseek(pFile, 0, SEEK_END);
+  int nFileSize = ftell(pFile);
+
+  // allocate reading buffer
+  pCsvFile->nDataBufferSize = nFileSize + 1 + READ_BUFFER_PADDING;
+  pCsvFile->pDataBuffer = (char*)malloc(pCsvFile->nDataBufferSize);
+
+  if (!pCsvFile->pDataBuffer) {
+    sprintf(szLastError, "Not enough memory for reading input file '%s' (%d bytes)", pCsvFile->szFileName, nFileSize);
+    puts(szLastError);
+    return -1;  // not enough free memory
+  }
+
+  // clear read buffer
+  memset(pCsvFile->pDataBuffer, 0, pCsvFile->nDataBufferSize);
+
+  // go to start of file
+  iReturnCode = fseek(pFile, 0, SEEK_SET);
+
+  // read content of file
+  int nBytesRead = fread(pCsvFile->pDataBuffer, pCsvFile->nDataBufferSize, 1, pFile);
+  //int nContentLength = strlen(pCsvDataBuffer);
+  //pchar pTest = pCsvDataBuffer + nCsvDataBufferSize - 8;
+
+  // close file
+  fclose(pFile);
+
+  // convert content to utf-8 (if necessary)
+  int nReturnCode = DecodeCsvBuffer(pCsvFile, nFileSize);
+  if (nReturnCode < 0)
+    return nReturnCode;
+
+  // convert all line ends to LF and count lines (CR/LF, LF and CR are accepted)
+  int nLines = NormalizeLineEnds(pCsvFile->pDataBuffer);
+
+  // initialize reading position
+  char *pReadPos = pCsvFile->pDataBuffer;
+
+  // fixed width file (column positions defined by the mapping) ?
+  char *pLine = NULL;
+  char *pFieldBufferPos = NULL;
+  bool bAsciiText = true;
+  int nFixedWidthFields = BuildFixedWidthFields(nCsvFileIndex, aField);
+
+  if (nFixedWidthFields > 0) {
+    // no header line, column names from the mapping definition
+    pCsvFile->nColumns = nFixedWidthFields;
+    cColumnDelimiter = ';';
+    *szCsvHeader = '\0';
+    for (i = 0; i < nFixedWidthFields && strlen(szCsvHeader) + strlen(aField[i]) + 2 < MAX_HEADER_SIZE; i++) {
+      if (i > 0)
+        strcat(szCsvHeader, ";");
+      strcat(szCsvHeader, aField[i]);
+    }
+    *szCsvHeader2 = '\0';
+    nLines++;  // first line is a data line
+  }
+  else {
+    // get header line with column names
+    pLine = GetNextLine(&pReadPos);
+    if (!pLine || *pLine <= '\n') {
+      sprintf(szLastError, "Missing or empty header line in input file '%s'", pCsvFile->szFileName);
+      puts(szLastError);
+      return -2;
+    }
+
+    // save header line
+    mystrncpy(szCsvHeader, pLine, MAX_HEADER_SIZE);
+    *szCsvHeader2 = '\0';
+
+    // detect column delimiter
+    cColumnDelimiter = GetColumnDelimiter(pLine);
+
+    // set list of characters to be ignored when parsing the csv line (outside of quoted values)
+    strcpy(szIgnoreChars, (cColumnDelimiter == '\t') ? " " : " \t");
+
+    // parse header line
+    pCsvFile->nColumns = GetFields(pLine, cColumnDelimiter, aField, MAX_CSV_COLUMNS);
+  }
+
+  // build index of column names
+  FreeNameIndex(&pCsvFile->HeaderIndex);
+  for (nColumnIndex = 0; nColumnIndex < pCsvFile->nColumns; nColumnIndex++)
+    if (AddNameIndexEntry(&pCsvFile->HeaderIndex, aField[nColumnIndex], nColumnIndex) != 0) {
+      sprintf(szLastError, "Not enough memory for header index of input file '%s'", pCsvFile->szFileName);
+      puts(szLastError);
+      return -1;  // not enough free memory
+    }
+
+  // search for fields referenced by the mapping definition (first matching column is used)
+  pFieldMapping = aFieldMapping;
+  for (nMapIndex = 0; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++) {
+    if (pFieldMapping->csv.cOperation == 'A'/*ADDFILE*/) {
+      if (pFieldMapping->nCsvFileIndex == nCsvFileIndex) {
+        // column of main file
+        pFieldMapping->nCsvIndex = FindNameIndexFirst(&pCsvFile->HeaderIndex, pFieldMapping->csv.szContent);
+        if (pFieldMapping->nCsvIndex >= 0 && pFieldMapping->nCsvFileIndex2 >= 0 && pFieldMapping->nCsvFileIndex2 < nLinkedCsvFiles)
+          aLinkedCsvFile[pFieldMapping->nCsvFileIndex2].nLinkedMainColumnIndex = pFieldMapping->nCsvIndex;
+      }
+      if (pFieldMapping->nCsvFileIndex2 == nCsvFileIndex) {
+        // column of linked file
+        pFieldMapping->nCsvIndex2 = FindNameIndexFirst(&pCsvFile->HeaderIndex, pFieldMapping->csv.szContent2);
+        if (pFieldMapping->nCsvIndex2 >= 0)
+          pCsvFile->nLinkedColumnIndex = pFieldMapping->nCsvIndex2;
+      }
+    }
+
+    if (strchr("CIMU"/*CHANGE,IF,MAP,UNIQUE*/, pFieldMapping->csv.cOperation) && pFieldMapping->nCsvFileIndex == nCsvFileIndex) {
+      // search for column in csv header line
+      nColumnIndex = FindNameIndexFirst(&pCsvFile->HeaderIndex, pFieldMapping->csv.szContent);
+      i = FindNameIndexFirst(&pCsvFile->HeaderIndex, pFieldMapping->csv.szContent2);
+      if (i >= 0 && (nColumnIndex < 0 || i < nColumnIndex))
+        nColumnIndex = i;
+      pFieldMapping->nCsvIndex = nColumnIndex;
+    }
+  }
+
+  // check for missing mandatory columns
+  pFieldMapping = aFieldMapping;
+  for (nMapIndex = 0; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++) {
+    if (pFieldMapping->csv.cOperation == 'A'/*ADDFILE*/) {
+      if (pFieldMapping->nCsvFileIndex == nCsvFileIndex && pFieldMapping->nCsvIndex < 0) {
+        sprintf(szErrorMessage, "Cannot find mandatory column in input file header");
+        LogCsvError(nCsvFileIndex, 0, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, szEmptyString, szErrorMessage);
+      }
+      if (pFieldMapping->nCsvFileIndex2 == nCsvFileIndex && pFieldMapping->nCsvIndex2 < 0) {
+        sprintf(szErrorMessage, "Cannot find mandatory column in input file header");
+        LogCsvError(nCsvFileIndex, 0, pFieldMapping->nCsvIndex2, pFieldMapping->csv.szContent2, szEmptyString, szErrorMessage);
+      }
+    }
+
+    if (strchr("CIMU"/*CHANGE,IF,MAP,UNIQUE*/, pFieldMapping->csv.cOperation)) {
+      // within conditional block ?
+      bCheck = true;
+      if (szIgnoreXPath) {
+        if (strncmp(pFieldMapping->xml.szContent, szIgnoreXPath, strlen(szIgnoreXPath)) == 0)
+          bCheck = false;  // yes, still within conditional block to be skipped
+        else
+          szIgnoreXPath = NULL;  // no, end of conditional block reached
+      }
+
+      if (pFieldMapping->nCsvFileIndex == nCsvFileIndex) {
+        // mandatory column missing in header line ?
+        if (bCheck && pFieldMapping->nCsvIndex < 0 && pFieldMapping->csv.bMandatory) {
+          sprintf(szErrorMessage, "Cannot find mandatory column in input file header");
+          LogCsvError(pFieldMapping->nCsvFileIndex, 0, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, szEmptyString, szErrorMessage);
+        }
+      }
+
+      // start of new IF block ?
+      if (!szIgnoreXPath && pFieldMapping->csv.cOperation == 'I')
+        szIgnoreXPath = pFieldMapping->xml.szContent;
+    }
+  }
+
+  // resolve column names used in csv conditions
+  ResolveCsvConditions();
+
+  // data lines of main csv file filtered by condition ?
+  bool bRowFilter = (convDir == CSV2XML && nCsvFileIndex == 0 && (RowFilter.pSimpleCondition || RowFilter.pComplexCondition));
+  if (bRowFilter)
+    ResolveCsvConditionColumns(&RowFilter, nCsvFileIndex, false);
+
+  // column that must not be empty in data lines
+  if (*szKeyColumnName) {
+    nKeyColumnIndex = FindNameIndexFirst(&pCsvFile->HeaderIndex, szKeyColumnName);
+    if (nKeyColumnIndex < 0 && nCsvFileIndex == 0 && convDir == CSV2XML)
+      printf("Key column '%s' not found in header line of input file '%s'\n", szKeyColumnName, pCsvFile->szFileName);
+  }
+
+  // number of lines behind the header line (minimum 1 for the field pointer array)
+  pCsvFile->nDataLines = (nLines > 2) ? nLines - 1 : 1;
+
+  // allocate memory for field pointer array
+  pCsvFile->nDataFieldsBufferSize = pCsvFile->nDataLines * pCsvFile->nColumns * sizeof(pchar);
+  pCsvFile->aDataFields = (pchar*)malloc(pCsvFile->nDataFieldsBufferSize);
+
+  if (!pCsvFile->aDataFields) {
+    sprintf(szLastError, "Not enough memory for csv content field buffer input file '%s' (%d bytes for %d lines and %d columns)", pCsvFile->szFileName, pCsvFile->nDataFieldsBufferSize, pCsvFile->nDataLines, pCsvFile->nColumns);
+    puts(szLastError);
+    return -1;  // not enough free memory
+  }
+
+  if (nFixedWidthFields > 0) {
+    // allocate buffer for the content of the fixed width fields (utf-8 characters up to 4 bytes)
+    size_t nFieldBufferSize = nFixedWidthFields;
+    bAsciiText = IsAsciiText(pReadPos);
+    for (i = 0; i < nFixedWidthFields; i++)
+      nFieldBufferSize += (size_t)pCsvFile->aFixedWidthField[i].nWidth * (bAsciiText ? 1 : 4);
+    nFieldBufferSize *= pCsvFile->nDataLines;
+    pCsvFile->pFieldBuffer = (char*)malloc(nFieldBufferSize + 1);
+
+    if (!pCsvFile->pFieldBuffer) {
+      sprintf(szLastError, "Not enough memory for fixed width fields of input file '%s' (%.0lf bytes)", pCsvFile->szFileName, (double)nFieldBufferSize);
+      puts(szLastError);
+      return -1;  // not enough free memory
+    }
+    pFieldBufferPos = pCsvFile->pFieldBuffer;
+  }
+
+  // initialize flags whether csv values has been quoted or not
+  for (i = 0; i < pCsvFile->nColumns; i++)
+    pCsvFile->abColumnQuoted[i] = false;
+
+  // clear field pointer array
+  memset(pCsvFile->aDataFields, 0, pCsvFile->nDataFieldsBufferSize);
+
+  pchar *pCsvDataFields = pCsvFile->aDataFields;
+
+  while (pLine = GetNextLine(&pReadPos)) {
+    //if (nRealCsvDataLines >= 761)
+    //  i = 0;  // for debugging purposes only!
+
+    if (nFixedWidthFields > 0) {
+      // copy fixed width fields (skip comment lines and lines with too few fields or missing key column)
+      if (!SliceFixedWidthLine(pCsvFile, pLine, bAsciiText, aField, &pFieldBufferPos, nKeyColumnIndex))
+        continue;
+      nColumns = nFixedWidthFields;
+    }
+    else {
+      // skip empty lines, comment lines and lines with too few columns or missing key column (before parsing the fields)
+      if (!IsAcceptedCsvLine(pLine, pCsvFile->nColumns, nKeyColumnIndex))
+        continue;
+
+      if (pCsvFile->nRealDataLines == 0 && !*szCsvHeader2)
+        mystrncpy(szTempHeader, pLine, MAX_HEADER_SIZE);
+
+      // parse current csv line
+      nColumns = GetFields(pLine, cColumnDelimiter, aField, pCsvFile->nColumns, (pCsvFile->nRealDataLines == 0) ? pCsvFile->abColumnQuoted : NULL);
+    }
+    bStoreLine = true;
+
+    if (pCsvFile->nRealDataLines == 0 && !*szCsvHeader2 && nFixedWidthFields == 0) {
+      // check existance of second header line (count mappings with matching column names)
+      nFound = 0;
+      memset(abMappingFound, 0, sizeof(abMappingFound));
+
+      for (nColumnIndex = 0; nColumnIndex < nColumns; nColumnIndex++) {
+        nMatches = FindNameIndexMatches(&MappingColumnIndex, aField[nColumnIndex], anMatch, 2 * MAX_FIELD_MAPPINGS);
+        for (i = 0; i < nMatches; i++) {
+          nMapIndex = anMatch[i] / 2;
+          if (!abMappingFound[nMapIndex] && strchr("CIMU"/*CHANGE,IF,MAP,UNIQUE*/, aFieldMapping[nMapIndex].csv.cOperation)) {
+            abMappingFound[nMapIndex] = true;
+            nFound++;
+          }
+        }
+      }
+
+      if (nFound >= pCsvFile->nColumns / 2) {
+        // save second header line, if minimum half of the columns is matching column names
+        mystrncpy(szCsvHeader2, szTempHeader, MAX_HEADER_SIZE);
+        bStoreLine = false;
+      }
+    }
+
+    if (bStoreLine && bRowFilter && !EvaluateCsvRowCondition((cpchar const*)aField, nColumns, &RowFilter)) {
+      // data line skipped by row filter
+      pCsvFile->nFilteredDataLines++;
+      bStoreLine = false;
+    }
+
+    if (bStoreLine && pCsvFile->nRealDataLines < pCsvFile->nDataLines) {
+      // copy pointer of fields content to field pointer array
+      memcpy(pCsvDataFields, aField, nColumns * sizeof(pchar));
+      // initialize non existing fields at the end of the line with empty strings
+      for (i = nColumns; i < pCsvFile->nColumns; i++)
+        pCsvDataFields[i] = (pchar)szEmptyString;
+      // next line
+      pCsvDataFields += pCsvFile->nColumns;
+      pCsvFile->nRealDataLines++;
+    }
+  }
+
+  return nFieldMappings;
+}
+// end of function "ReadCsvData"
+
+//--------------------------------------------------------------------------------------------------------
+
+cpchar GetCsvFieldValue(int nCsvFileIndex, int nCsvDataLine, int nCsvColumn)
+{
+  cpchar pResult = NULL;
+  LinkedCsvFile *pLinkedCsvFile;
+
+  if (nCsvFileIndex >= 0 && nCsvFileIndex < nLinkedCsvFiles) {
+    pLinkedCsvFile = aLinkedCsvFile + nCsvFileIndex;
+    if (nCsvDataLine >= 0 && nCsvDataLine < pLinkedCsvFile->nRealDataLines && nCsvColumn >= 0 && nCsvColumn < pLinkedCsvFile->nColumns)
+      pResult = pLinkedCsvFile->aDataFields[nCsvDataLine * pLinkedCsvFile->nColumns + nCsvColumn];
+  }
+
+  return pResult;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+cpchar GetLinkedCsvFieldValue(int nCsvFileIndex, int nCsvDataLine, int nCsvColumn)
+{
+  // get csv field value within current table window (starting at nMatchingFirstLine and ending at nMatchingLastLine)
+  cpchar pResult = NULL;
+  LinkedCsvFile *pLinkedCsvFile;
+
+  if (nCsvFileIndex >= 0 && nCsvFileIndex < nLinkedCsvFiles) {
+    pLinkedCsvFile = aLinkedCsvFile + nCsvFileIndex;
+    if (pLinkedCsvFile->nMatchingFirstLine >= 0 && pLinkedCsvFile->nMatchingLastLine >= 0) {
+      int nRealCsvDataLine = nCsvDataLine + pLinkedCsvFile->nMatchingFirstLine;
+      if (nRealCsvDataLine >= pLinkedCsvFile->nMatchingFirstLine && nRealCsvDataLine <= pLinkedCsvFile->nMatchingLastLine && nCsvColumn >= 0 && nCsvColumn < pLinkedCsvFile->nColumns)
+        pResult = pLinkedCsvFile->aDataFields[nRealCsvDataLine * pLinkedCsvFile->nColumns + nCsvColumn];
+    }
+  }
+
+  return pResult;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+bool IsInternedCsvColumn(int nCsvFileIndex, int nCsvColumn)
+{
+  // are all values of the csv column replaced by the pointers of the value dictionary ?
+  LinkedCsvFile *pLinkedCsvFile;
+
+  if (nCsvFileIndex < 0 || nCsvFileIndex >= nLinkedCsvFiles)
+    return false;
+
+  pLinkedCsvFile = aLinkedCsvFile + nCsvFileIndex;
+
+  return pLinkedCsvFile->aInternedColumn && nCsvColumn >= 0 && nCsvColumn < pLinkedCsvFile->nColumns && pLinkedCsvFile->aInternedColumn[nCsvColumn].anValueId;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int InternCsvColumn(int nCsvFileIndex, int nCsvColumn)
+{
+  // assign dictionary ids to all values of a csv column and replace equal values by the same pointer
+  // (equal values of interned columns can be compared by pointer, first line of each value is stored)
+  int i, nId;
+  LinkedCsvFile *pCsvFile = aLinkedCsvFile + nCsvFileIndex;
+  InternedColumn *pInternedColumn;
+  pchar *ppCsvDataField;
+
+  if (nCsvColumn < 0 || nCsvColumn >= pCsvFile->nColumns || !pCsvFile->aDataFields || IsInternedCsvColumn(nCsvFileIndex, nCsvColumn))
+    return 0;  // nothing to do
+
+  if (!pCsvFile->aInternedColumn) {
+    pCsvFile->aInternedColumn = (InternedColumn*)calloc(pCsvFile->nColumns, sizeof(InternedColumn));
+    if (!pCsvFile->aInternedColumn)
+      return -1;
+  }
+
+  pInternedColumn = pCsvFile->aInternedColumn + nCsvColumn;
+  pInternedColumn->anValueId = (int*)malloc((pCsvFile->nRealDataLines + 1) * sizeof(int));
+  if (!pInternedColumn->anValueId)
+    return -1;
+
+  ppCsvDataField = pCsvFile->aDataFields + nCsvColumn;
+  for (i = 0; i < pCsvFile->nRealDataLines; i++, ppCsvDataField += pCsvFile->nColumns) {
+    nId = GetDictionaryId(&CsvValueDictionary, *ppCsvDataField);
+    if (nId < 0)
+      return -1;
+    pInternedColumn->anValueId[i] = nId;
+    *ppCsvDataField = (pchar)CsvValueDictionary.aEntry[nId].pszValue;
+  }
+
+  // first line of each value within this column
+  pInternedColumn->nValueIds = CsvValueDictionary.nEntries;
+  pInternedColumn->anFirstLine = (int*)malloc((pInternedColumn->nValueIds + 1) * sizeof(int));
+  if (!pInternedColumn->anFirstLine)
+    return -1;
+  memset(pInternedColumn->anFirstLine, -1, (pInternedColumn->nValueIds + 1) * sizeof(int));
+  for (i = pCsvFile->nRealDataLines - 1; i >= 0; i--)
+    pInternedColumn->anFirstLine[pInternedColumn->anValueId[i]] = i;
+
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int InternCsvColumns()
+{
+  // intern columns of loops (CHANGE, UNIQUE) and key columns of linked csv files (repeating values)
+  int i, nMapIndex, nReturnCode = 0, nColumns = 0;
+  CPFieldMapping pFieldMapping = aFieldMapping;
+
+  for (nMapIndex = 0; nMapIndex < nFieldMappings && nReturnCode == 0; nMapIndex++, pFieldMapping++)
+    if (pFieldMapping->xml.cOperation == 'L'/*LOOP*/ && strchr("CU"/*CHANGE,UNIQUE*/, pFieldMapping->csv.cOperation) && pFieldMapping->nCsvIndex >= 0 && pFieldMapping->nCsvFileIndex >= 0 && pFieldMapping->nCsvFileIndex < nLinkedCsvFiles) {
+      nReturnCode = InternCsvColumn(pFieldMapping->nCsvFileIndex, pFieldMapping->nCsvIndex);
+      nColumns++;
+    }
+
+  for (i = 1; i < nLinkedCsvFiles && nReturnCode == 0; i++)
+    if (aLinkedCsvFile[i].nLinkedMainColumnIndex >= 0 && aLinkedCsvFile[i].nLinkedColumnIndex >= 0) {
+      nReturnCode = InternCsvColumn(0, aLinkedCsvFile[i].nLinkedMainColumnIndex);
+      if (nReturnCode == 0)
+        nReturnCode = InternCsvColumn(i, aLinkedCsvFile[i].nLinkedColumnIndex);
+      nColumns += 2;
+    }
+
+  if (nReturnCode != 0) {
+    strcpy(szLastError, "Not enough memory for dictionary of csv values");
+    puts(szLastError);
+  }
+  else if (bTrace)
+    printf("Interned csv columns: %d (%d distinct values)\n", nColumns, CsvValueDictionary.nEntries);
+
+  return nReturnCode;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+bool IsNewCsvFieldValue(int nCsvFileIndex, int nCsvDataLines, int nCsvColumn, cpchar szCsvValue)
+{
+  bool bResult = false;
+  LinkedCsvFile *pLinkedCsvFile;
+
+  if (nCsvFileIndex >= 0 && nCsvFileIndex < nLinkedCsvFiles) {
+    pLinkedCsvFile = aLinkedCsvFile + nCsvFileIndex;
+    if (nCsvDataLines >= 0 && nCsvDataLines < pLinkedCsvFile->nRealDataLines && nCsvColumn >= 0 && nCsvColumn < pLinkedCsvFile->nColumns) {
+      if (IsInternedCsvColumn(nCsvFileIndex, nCsvColumn)) {
+        // value is new, if it appears in this line for the first time
+        InternedColumn *pInternedColumn = pLinkedCsvFile->aInternedColumn + nCsvColumn;
+        return pInternedColumn->anFirstLine[pInternedColumn->anValueId[nCsvDataLines]] == nCsvDataLines;
+      }
+      bResult = true;
+      cpchar *ppCsvValue = (cpchar*)(pLinkedCsvFile->aDataFields + nCsvColumn);
+      for (int i = 0; i < nCsvDataLines; i++) {
+        if (strcmp(szCsvValue, *ppCsvValue) == 0)
+          return false;
+        ppCsvValue += pLinkedCsvFile->nColumns;
+      }
+    }
+  }
+
+  return bResult;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int GetNumberOfDigits(cpchar szValue)
+{
+  int nResult = 0;
+
+  for (cpchar pPos = szValue; *pPos >= '0' && *pPos <= '9'; pPos++)
+    nResult++;
+
+  return nResult;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int GetCsvDecimalPoint()
+{
+  int i, nColumnIndex, nMapIndex, nDigitsBehindComma, nDigitsBehindPoint;
+  int nCommaUsage = 0;
+  int nPointUsage = 0;
+  int nReturnCode = 0;
+  pchar *ppCsvDataField;
+  cpchar pCsvFieldValue = NULL;
+  cpchar pCommaPos = NULL;
+  cpchar pPointPos = NULL;
+  CPFieldMapping pFieldMapping = aFieldMapping;
+  LinkedCsvFile *pCsvFile = aLinkedCsvFile;
+
+  for (nMapIndex = 0; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++) {
+    if (pFieldMapping->csv.cType == 'N'/*NUMBER*/ && pFieldMapping->csv.cOperation == 'M'/*MAP*/ && pFieldMapping->nCsvIndex >= 0)
+    {
+      nColumnIndex = pFieldMapping->nCsvIndex;
+      ppCsvDataField = pCsvFile->aDataFields + nColumnIndex;
+
+      for (i = 0; i < pCsvFile->nRealDataLines; i++) {
+        pCsvFieldValue = *ppCsvDataField;
+        //pCsvFieldValue = GetCsvFieldValue(i, nColumnIndex);
+
+        pCommaPos = strchr(pCsvFieldValue, ',');
+        if (pCommaPos)
+          nDigitsBehindComma = GetNumberOfDigits(pCommaPos+1);
+        else
+          nDigitsBehindComma = -1;
+
+        pPointPos = strchr(pCsvFieldValue, '.');
+        if (pPointPos)
+          nDigitsBehindPoint = GetNumberOfDigits(pPointPos+1);
+        else
+          nDigitsBehindPoint = -1;
+
+        if (pCommaPos) {
+          if (pPointPos) {
+            if (pCommaPos > pPointPos)
+              nCommaUsage++;  // comma is behind point
+            else
+              nPointUsage++;  // point is behind comma
           }
+          else
+            if (nDigitsBehindComma != 3)
+              nCommaUsage++;  // high probability of comma used as decimal point
         }
-
-        // check syntax of mapping format columns
-        // Samples: "'PRAEFIX-'*", "*'-POSTFIX'"
-        if (!IsValidMappingFormat(pFieldMapping->csv.szMappingFormat)) {
-          sprintf(szLastError, "Invalid csv mapping format \"%s\" (valid samples: \"'PRAEFIX-'*\", \"*'-POSTFIX'\")", pFieldMapping->csv.szMappingFormat);
-          LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->csv.cOperation), "CSV_MAPPING_FORMAT", szLastError);
-          pFieldMapping->csv.szMappingFormat = szEmptyString;
-        }
-        if (!IsValidMappingFormat(pFieldMapping->xml.szMappingFormat)) {
-          sprintf(szLastError, "Invalid xml mapping format \"%s\" (valid samples: \"'PRAEFIX-'*\", \"*'-POSTFIX'\")", pFieldMapping->xml.szMappingFormat);
-          LogMappingError(nMapIndex, GetOperationLongName(pFieldMapping->xml.cOperation), "XML_MAPPING_FORMAT", szLastError);
-          pFieldMapping->xml.szMappingFormat = szEmptyString;
+        else {
+          if (pPointPos && nDigitsBehindPoint != 3)
+            nPointUsage++;  // high probability of point used as decimal point
         }
 
-        pFieldMapping->nCsvIndex = -1;
-        pFieldMapping->nCsvIndex2 = -1;
-        pFieldMapping->nSourceMapIndex = -1;
-        pFieldMapping++;
-        nFieldMappings++;
+        // increment data field pointer to next csv line
+        ppCsvDataField += pCsvFile->nColumns;
       }
     }
   }
 
-  // search for field content mapping of source columns
-  for (nMapIndex = 0, pFieldMapping = aFieldMapping; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++)
-    if (strchr("CIU"/*CHANGE,IF,UNIQUE*/, pFieldMapping->csv.cOperation)) {
-      // search for content mapping of source column
-      for (nMapIndex2 = 0, pFieldMapping2 = aFieldMapping; nMapIndex2 < nFieldMappings; nMapIndex2++, pFieldMapping2++)
-        if (pFieldMapping2->csv.cOperation == 'M' && pFieldMapping2->xml.cOperation == 'M' && strcmp(pFieldMapping->csv.szContent, pFieldMapping2->csv.szContent) == 0) {
-          pFieldMapping->nSourceMapIndex = nMapIndex2;
-          nMapIndex2 = nFieldMappings;
-        }
-    }
+  cDecimalPoint = (nCommaUsage > nPointUsage) ? ',' : '.';
+  return nReturnCode;
+}
 
-  if (nFieldMappings == 0) {
-    sprintf(szLastError, "No field mappings found in '%s'", szFileName);
-    puts(szLastError);
+//--------------------------------------------------------------------------------------------------------
+
+int ConvertCsvCell(CPFieldMapping pFieldMapping, cpchar pCsvValue, int nCsvDataLine, pchar pXmlValue, int nMaxLen)
+{
+  // check and convert csv value like MapCsvToXmlValue without logging errors (decoded value of option -typed if available)
+  TypedValue const *pTypedValue = GetTypedCsvValue(pFieldMapping, nCsvDataLine);
+  int nErrorCode;
+
+  if (*pCsvValue && pTypedValue) {
+    nErrorCode = IsTypedValueInRange(pFieldMapping, nCsvDataLine) ? 0 : CheckTypedMinMaxValues(pTypedValue, &pFieldMapping->csv);
+    if (nErrorCode != 0)
+      return nErrorCode;
+    if (FormatTypedValue(pTypedValue, pFieldMapping->xml.cType, &pFieldMapping->xml.DateFormat, pXmlValue, nMaxLen) == 0)
+      return 0;
   }
 
-  return nFieldMappings;
+  return ConvertCsvToXmlValue(pFieldMapping, pCsvValue, pXmlValue, nMaxLen, true);
 }
-// end of function "ReadFieldMappings"
 
 //--------------------------------------------------------------------------------------------------------
 
-void FreeCsvFileBuffers()
+void RunValidationTasks()
 {
-  LinkedCsvFile *pLinkedCsvFile = aLinkedCsvFile;
+  // validate csv values of the next free task until all tasks are done (executed by all validation threads)
+  // xml values of valid csv values are kept in the buffer of the task, so the generator does not convert them again
+  char szXmlValue[MAX_VALUE_SIZE];
+  int nTask, nLine, nLen, nErrorCode;
+  ValidationTask *pTask;
+  CPFieldMapping pFieldMapping;
+  cpchar pCsvValue;
+  pchar pNewValues;
+  bool bDefault;
 
-  for (int i = 0; i < nLinkedCsvFiles; i++) {
-    if (pLinkedCsvFile->pDataBuffer != NULL) {
-      free(pLinkedCsvFile->pDataBuffer);
-      pLinkedCsvFile->pDataBuffer = NULL;
-    }
-    if (pLinkedCsvFile->aDataFields != NULL) {
-      free(pLinkedCsvFile->aDataFields);
-      pLinkedCsvFile->aDataFields = NULL;
+  while ((nTask = ATOMIC_FETCH_INCREMENT(&nNextValidationTask)) < nValidationTasks) {
+    pTask = aValidationTask + nTask;
+    pFieldMapping = aFieldMapping + pTask->nMapIndex;
+
+    for (nLine = pTask->nFirstLine; nLine < pTask->nLastLine; nLine++) {
+      pCsvValue = GetCsvFieldValue(pFieldMapping->nCsvFileIndex, nLine, pFieldMapping->nCsvIndex);
+      if (!pCsvValue)
+        pCsvValue = szEmptyString;
+
+      // no csv field value available, but default value defined ?
+      bDefault = (!*pCsvValue && *pFieldMapping->csv.szDefault);
+      if (bDefault)
+        pCsvValue = pFieldMapping->csv.szDefault;
+
+      *szXmlValue = '\0';
+      nErrorCode = ConvertCsvCell(pFieldMapping, pCsvValue, bDefault ? -1 : nLine, szXmlValue, MAX_VALUE_SIZE);
+      if (nErrorCode != 0) {
+        pFieldMapping->anCellError[nLine] = (nErrorCode > 0 && nErrorCode < 255) ? (unsigned char)nErrorCode : 255;
+        pTask->nErrors++;
+        continue;
+      }
+
+      // keep xml value (default values and empty values are converted when used)
+      if (!pFieldMapping->Converted.anOffset || !*pCsvValue || bDefault || !pFieldMapping->pConvertCsvToXml)
+        continue;
+      nLen = (int)strlen(szXmlValue) + 1;
+      if (pTask->nUsed + nLen > pTask->nSize) {
+        pNewValues = (pchar)realloc(pTask->pValues, 2 * pTask->nSize + MAX_VALUE_SIZE);
+        if (!pNewValues)
+          continue;  // converted when used
+        pTask->pValues = pNewValues;
+        pTask->nSize = 2 * pTask->nSize + MAX_VALUE_SIZE;
+      }
+      memcpy(pTask->pValues + pTask->nUsed, szXmlValue, nLen);
+      pFieldMapping->Converted.anOffset[nLine] = pTask->nUsed;
+      pTask->nUsed += nLen;
     }
-    pLinkedCsvFile++;
   }
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-bool MatchingColumnName(cpchar pszColumnName, cpchar pszSearchColumnName)
+int MoveValidatedValues()
 {
-  // Compares given csv column name with search pattern from mapping definition
-  // If search pattern contains asterics '*' at the end, then rest of the column name is ignored
-  // Sample: column name "3_Portfolio_name" is matching "3_*"
-  //
-  bool bMatch;
-
-  if (!pszColumnName || !*pszColumnName || !pszSearchColumnName || !*pszSearchColumnName)
-    return false;
-
-  int nPos = strlen(pszSearchColumnName) - 1;
+  // move xml values of the validation tasks into one buffer per field mapping (same as option -batch)
+  int i, nLine, nMapIndex;
+  ValidationTask *pTask;
+  FieldMapping *pFieldMapping;
+  ConvertedColumn *pColumn;
+
+  // size of the values per field mapping
+  for (i = 0, pTask = aValidationTask; i < nValidationTasks; i++, pTask++)
+    aFieldMapping[pTask->nMapIndex].Converted.nSize += pTask->nUsed;
+
+  for (nMapIndex = 0, pFieldMapping = aFieldMapping; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++) {
+    pColumn = &pFieldMapping->Converted;
+    if (!pColumn->anOffset)
+      continue;
+    pColumn->pValues = (pchar)malloc(pColumn->nSize + 1);
+    if (!pColumn->pValues) {
+      strcpy(szLastError, "Not enough memory for converted csv columns");
+      puts(szLastError);
+      return -1;
+    }
+  }
 
-  if (nPos > 0 && pszSearchColumnName[nPos] == '*')
-    bMatch = (strnicmp(pszColumnName, pszSearchColumnName, nPos) == 0);
-  else
-    bMatch = (stricmp(pszColumnName, pszSearchColumnName) == 0);
+  // append values of each task and move offsets behind the values of the previous tasks
+  for (i = 0, pTask = aValidationTask; i < nValidationTasks; i++, pTask++) {
+    pColumn = &aFieldMapping[pTask->nMapIndex].Converted;
+    if (!pColumn->anOffset || !pTask->nUsed)
+      continue;
+    memcpy(pColumn->pValues + pColumn->nUsed, pTask->pValues, pTask->nUsed);
+    for (nLine = pTask->nFirstLine; nLine < pTask->nLastLine; nLine++)
+      if (pColumn->anOffset[nLine] >= 0)
+        pColumn->anOffset[nLine] += pColumn->nUsed;
+    pColumn->nUsed += pTask->nUsed;
+  }
 
-  return bMatch;
+  return 0;
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-void ResetFieldIndices()
+#ifdef _WIN32
+DWORD WINAPI ValidationThread(LPVOID pParameter)
+#else
+void *ValidationThread(void *pParameter)
+#endif
 {
-  // reset field indices
-  FieldMapping *pFieldMapping = aFieldMapping;
-	for (int i = 0; i < nFieldMappings; i++, pFieldMapping++)  {
-    pFieldMapping->nCsvIndex = -1;
-    pFieldMapping->nCsvIndex2 = -1;
-  }
+  (void)pParameter;
+  RunValidationTasks();
+  return 0;
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-int ReadCsvData(int nCsvFileIndex)
+int ValidateCsvColumns(int nThreads)
 {
-  // read and parse content of csv file
-  int i, nColumnIndex, nMapIndex, nColumns, nNonEmptyColumns, nFound;
-  LinkedCsvFile *pCsvFile = aLinkedCsvFile + nCsvFileIndex;
-  char *pColumnName = NULL;
-  char szErrorMessage[MAX_ERROR_MESSAGE_SIZE];
-  char szTempHeader[MAX_HEADER_SIZE];
-  cpchar szIgnoreXPath = NULL;
-  pchar aField[MAX_CSV_COLUMNS];
-  FieldMapping *pFieldMapping = NULL;
-  FILE *pFile = NULL;
-  //errno_t error_code;
-  bool bCheck, bFound;
+  // check all mapped csv values before generating the xml document (in parallel over columns and line ranges)
+  // the result per csv line (0 = valid, otherwise error code) and the xml values are stored in the field mapping
+  int i, nMapIndex, nLine, nLines, nTasks = 0, nErrors = 0, nStartedThreads = 0, nReturnCode;
+  FieldMapping *pFieldMapping;
+  ThreadHandle aThread[MAX_VALIDATION_THREADS];
+
+  // count tasks and allocate result arrays
+  for (nMapIndex = 0, pFieldMapping = aFieldMapping; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++) {
+    if (pFieldMapping->csv.cOperation != 'M'/*MAP*/ || pFieldMapping->xml.cOperation != 'M'/*MAP*/ || pFieldMapping->nCsvIndex < 0)
+      continue;
+    if (pFieldMapping->nCsvFileIndex < 0 || pFieldMapping->nCsvFileIndex >= nLinkedCsvFiles)
+      continue;
+
+    nLines = aLinkedCsvFile[pFieldMapping->nCsvFileIndex].nRealDataLines;
+    pFieldMapping->anCellError = (unsigned char*)calloc(nLines + 1, 1);
+    if (!pFieldMapping->anCellError) {
+      strcpy(szLastError, "Not enough memory for validation results");
+      puts(szLastError);
+      return -1;
+    }
 
-  // initialize buffer pointers and number of columns and csv data lines
-  pCsvFile->pDataBuffer = NULL;
-  pCsvFile->aDataFields = NULL;
-  pCsvFile->nColumns = 0;
-  pCsvFile->nDataLines = 0;
-  pCsvFile->nRealDataLines = 0;
+    // xml values of valid csv values are kept for the generator (-1 = converted when used)
+    if (!bValidateOnly && pFieldMapping->pConvertCsvToXml) {
+      pFieldMapping->Converted.anOffset = (int*)malloc((nLines + 1) * sizeof(int));
+      if (!pFieldMapping->Converted.anOffset) {
+        strcpy(szLastError, "Not enough memory for validation results");
+        puts(szLastError);
+        return -1;
+      }
+      memset(pFieldMapping->Converted.anOffset, 0xFF, (nLines + 1) * sizeof(int));
+      pFieldMapping->Converted.nSize = 0;
+      pFieldMapping->Converted.nUsed = 0;
+    }
+    nTasks += (nLines + VALIDATION_TASK_LINES - 1) / VALIDATION_TASK_LINES;
+  }
 
-  // open csv file for input in binary mode (cr/lf are not changed)
-  //error_code = fopen_s(&pFile, pCsvFile->szFileName, "rb");
-  pFile = fopen(pCsvFile->szFileName, "rb");
-  if (!pFile) {
-    //sprintf(szLastError, "Cannot open input file '%s' (error code %d)", pCsvFile->szFileName, error_code);
-    sprintf(szLastError, "Cannot open input file '%s'", pCsvFile->szFileName);
+  // split columns into ranges of csv lines
+  aValidationTask = (ValidationTask*)calloc(nTasks + 1, sizeof(ValidationTask));
+  if (!aValidationTask) {
+    strcpy(szLastError, "Not enough memory for validation tasks");
     puts(szLastError);
-    return -2;
+    return -1;
   }
 
-  // get file size
-  //int fseek(FILE *stream, long offset, int whence);
-  int iReturnCode = fseek(pFile, 0, SEEK_END);
-  int nFileSize = ftell(pFile);
+  nValidationTasks = 0;
+  for (nMapIndex = 0, pFieldMapping = aFieldMapping; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++) {
+    if (!pFieldMapping->anCellError)
+      continue;
+    nLines = aLinkedCsvFile[pFieldMapping->nCsvFileIndex].nRealDataLines;
+    for (nLine = 0; nLine < nLines; nLine += VALIDATION_TASK_LINES) {
+      aValidationTask[nValidationTasks].nMapIndex = nMapIndex;
+      aValidationTask[nValidationTasks].nFirstLine = nLine;
+      aValidationTask[nValidationTasks].nLastLine = (nLine + VALIDATION_TASK_LINES < nLines) ? nLine + VALIDATION_TASK_LINES : nLines;
+      nValidationTasks++;
+    }
+  }
+  nNextValidationTask = 0;
 
-  // allocate reading buffer
-  pCsvFile->nDataBufferSize = nFileSize + 1;
-  pCsvFile->pDataBuffer = (char*)malloc(pCsvFile->nDataBufferSize);
+  // start additional threads (the current thread is working too)
+  if (nThreads > nValidationTasks)
+    nThreads = nValidationTasks;
+  for (i = 1; i < nThreads && i < MAX_VALIDATION_THREADS; i++) {
+#ifdef _WIN32
+    aThread[nStartedThreads] = CreateThread(NULL, 0, ValidationThread, NULL, 0, NULL);
+    if (aThread[nStartedThreads] == NULL)
+      break;
+#else
+    if (pthread_create(&aThread[nStartedThreads], NULL, ValidationThread, NULL) != 0)
+      break;
+#endif
+    nStartedThreads++;
+  }
 
-  if (!pCsvFile->pDataBuffer) {
-    sprintf(szLastError, "Not enough memory for reading input file '%s' (%d bytes)", pCsvFile->szFileName, nFileSize);
-    puts(szLastError);
-    return -1;  // not enough free memory
+  RunValidationTasks();
+
+  // wait for the end of all threads
+  for (i = 0; i < nStartedThreads; i++) {
+#ifdef _WIN32
+    WaitForSingleObject(aThread[i], INFINITE);
+    CloseHandle(aThread[i]);
+#else
+    pthread_join(aThread[i], NULL);
+#endif
   }
 
-  // clear read buffer
-  memset(pCsvFile->pDataBuffer, 0, pCsvFile->nDataBufferSize);
+  for (i = 0; i < nValidationTasks; i++)
+    nErrors += aValidationTask[i].nErrors;
 
-  // go to start of file
-  iReturnCode = fseek(pFile, 0, SEEK_SET);
+  printf("Validation: %d tasks in %d threads, %d invalid csv values\n\n", nValidationTasks, nStartedThreads + 1, nErrors);
 
-  // read content of file
-  int nBytesRead = fread(pCsvFile->pDataBuffer, pCsvFile->nDataBufferSize, 1, pFile);
-  //int nContentLength = strlen(pCsvDataBuffer);
-  //pchar pTest = pCsvDataBuffer + nCsvDataBufferSize - 8;
+  nReturnCode = MoveValidatedValues();
 
-  // close file
-  fclose(pFile);
+  for (i = 0; i < nValidationTasks; i++)
+    free(aValidationTask[i].pValues);
+  free(aValidationTask);
+  aValidationTask = NULL;
+  nValidationTasks = 0;
 
-  // initialize reading position
-  char *pReadPos = pCsvFile->pDataBuffer;
+  return nReturnCode;
+}
 
-  // get header line with column names
-  char *pLine = GetNextLine(&pReadPos);
-  if (!pLine || *pLine <= '\n') {
-    sprintf(szLastError, "Missing or empty header line in input file '%s'", pCsvFile->szFileName);
-    puts(szLastError);
-    return -2;
+//--------------------------------------------------------------------------------------------------------
+
+int ValidateCsvDocument()
+{
+  // check all mapped csv values and log the errors without building the xml document (option -validate)
+  // errors are logged in the order of the csv lines and the mapping definitions (first error of each csv cell)
+  int nCsvFileIndex, nLine, nMapIndex, nReturnCode;
+  char szXmlValue[MAX_VALUE_SIZE];
+  LinkedCsvFile *pLinkedCsvFile;
+  CPFieldMapping pFieldMapping;
+  cpchar pCsvValue;
+  bool bDefault;
+
+  nReturnCode = ValidateCsvColumns((nValidationThreads > 0) ? nValidationThreads : 1);
+  if (nReturnCode != 0)
+    return nReturnCode;
+
+  for (nCsvFileIndex = 0; nCsvFileIndex < nLinkedCsvFiles; nCsvFileIndex++) {
+    pLinkedCsvFile = aLinkedCsvFile + nCsvFileIndex;
+    for (nLine = 0; nLine < pLinkedCsvFile->nRealDataLines; nLine++) {
+      pLinkedCsvFile->nCurrentCsvLine = nLine;
+
+      for (nMapIndex = 0, pFieldMapping = aFieldMapping; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++) {
+        if (pFieldMapping->nCsvFileIndex != nCsvFileIndex || !pFieldMapping->anCellError || !pFieldMapping->anCellError[nLine])
+          continue;
+
+        // check invalid value again for the error message (decoded value of option -typed if available)
+        pCsvValue = GetCsvFieldValue(nCsvFileIndex, nLine, pFieldMapping->nCsvIndex);
+        if (!pCsvValue)
+          pCsvValue = szEmptyString;
+        bDefault = (!*pCsvValue && *pFieldMapping->csv.szDefault);
+        if (bDefault)
+          pCsvValue = pFieldMapping->csv.szDefault;
+
+        if (ConvertCsvCell(pFieldMapping, pCsvValue, bDefault ? -1 : nLine, szXmlValue, MAX_VALUE_SIZE) > 0)
+          LogXmlError(nCsvFileIndex, nLine, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, pFieldMapping->xml.szContent, pCsvValue, szLastFieldMappingError);
+      }
+    }
   }
 
-  // save header line
-  mystrncpy(szCsvHeader, pLine, MAX_HEADER_SIZE);
-  *szCsvHeader2 = '\0';
+  return 0;
+}
 
-  // detect column delimiter
-  cColumnDelimiter = GetColumnDelimiter(pLine);
+//--------------------------------------------------------------------------------------------------------
 
-  // set list of characters to be ignored when parsing the csv line (outside of quoted values)
-  strcpy(szIgnoreChars, (cColumnDelimiter == '\t') ? " " : " \t");
+int CheckTypedColumnLimits(TypedColumn *pTypedColumn, CPFieldDefinition pFieldDefinition, int nLines)
+{
+  // mark decoded values within the minimum and maximum value (errors are reported when the values are used)
+  char cType = pTypedColumn->cType;
+  RangeLimit const *pMinLimit = pFieldDefinition->pMinLimit;
+  RangeLimit const *pMaxLimit = pFieldDefinition->pMaxLimit;
+  TypedValue const *pTypedValue = pTypedColumn->aValue;
 
-  // parse header line
-  pCsvFile->nColumns = GetFields(pLine, cColumnDelimiter, aField, MAX_CSV_COLUMNS);
+  if (!pMinLimit && !pMaxLimit)
+    return 0;
 
-  // search for fields referenced by the mapping definition
-  pFieldMapping = aFieldMapping;
-  for (nMapIndex = 0; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++) {
-    //pFieldMapping->nCsvIndex = -1;
+  pTypedColumn->abInRange = (unsigned char *)calloc(nLines / 8 + 1, 1);
+  if (!pTypedColumn->abInRange)
+    return -1;
 
-    //if (strcmp(pFieldMapping->csv.szContent2,":2:Fund Name") == 0)
-    //  i = 0;  // for debugging purposes only!
+  for (int i = 0; i < nLines; i++, pTypedValue++) {
+    if (!(pTypedColumn->abValid[i >> 3] & (1 << (i & 7))))
+      continue;
+    if (pMinLimit && CompareWithRangeLimit(pTypedValue, cType, pMinLimit) < 0)
+      continue;
+    if (pMaxLimit && CompareWithRangeLimit(pTypedValue, cType, pMaxLimit) > 0)
+      continue;
+    pTypedColumn->abInRange[i >> 3] |= (unsigned char)(1 << (i & 7));
+  }
 
-    if (pFieldMapping->csv.cOperation == 'A'/*ADDFILE*/) {
-      if (pFieldMapping->nCsvFileIndex == nCsvFileIndex) {
-        for (nColumnIndex = 0; nColumnIndex < pCsvFile->nColumns; nColumnIndex++)
-          if (MatchingColumnName(aField[nColumnIndex], pFieldMapping->csv.szContent)) {
-            pFieldMapping->nCsvIndex = nColumnIndex;
-            if (pFieldMapping->nCsvFileIndex2 >= 0 && pFieldMapping->nCsvFileIndex2 < nLinkedCsvFiles)
-              aLinkedCsvFile[pFieldMapping->nCsvFileIndex2].nLinkedMainColumnIndex = nColumnIndex;
-            break;
-          }
-        if (pFieldMapping->nCsvIndex < 0) {
-          sprintf(szErrorMessage, "Cannot find mandatory column in input file header");
-          LogCsvError(nCsvFileIndex, 0, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, szEmptyString, szErrorMessage);
-        }
-      }
-      if (pFieldMapping->nCsvFileIndex2 == nCsvFileIndex) {
-        for (nColumnIndex = 0; nColumnIndex < pCsvFile->nColumns; nColumnIndex++)
-          if (MatchingColumnName(aField[nColumnIndex], pFieldMapping->csv.szContent2)) {
-            pFieldMapping->nCsvIndex2 = nColumnIndex;
-            pCsvFile->nLinkedColumnIndex = nColumnIndex;
-            break;
-          }
-        if (pFieldMapping->nCsvIndex2 < 0) {
-          sprintf(szErrorMessage, "Cannot find mandatory column in input file header");
-          LogCsvError(nCsvFileIndex, 0, pFieldMapping->nCsvIndex2, pFieldMapping->csv.szContent2, szEmptyString, szErrorMessage);
-        }
-      }
-    }
+  pTypedColumn->pRangeDefinition = pFieldDefinition;
 
-    if (strchr("CIMU"/*CHANGE,IF,MAP,UNIQUE*/, pFieldMapping->csv.cOperation)) {
-      //if (strcmp(pFieldMapping->csv.szContent2, "67_*") == 0)
-      //  i = 0;  // ColumnIndex = 68; for debugging purposes only!
+  return 0;
+}
 
-      if (pFieldMapping->nCsvFileIndex == nCsvFileIndex) {
-        // search for column in csv header line(s)
-        for (nColumnIndex = 0; nColumnIndex < pCsvFile->nColumns; nColumnIndex++)
-          if (MatchingColumnName(aField[nColumnIndex], pFieldMapping->csv.szContent) || MatchingColumnName(aField[nColumnIndex], pFieldMapping->csv.szContent2)) {
-            pFieldMapping->nCsvIndex = nColumnIndex;
-            break;
-          }
-      }
+//--------------------------------------------------------------------------------------------------------
 
-      // within conditional block ?
-      bCheck = true;
-      if (szIgnoreXPath) {
-        if (strncmp(pFieldMapping->xml.szContent, szIgnoreXPath, strlen(szIgnoreXPath)) == 0)
-          bCheck = false;  // yes, still within conditional block to be skipped
-        else
-          szIgnoreXPath = NULL;  // no, end of conditional block reached
-      }
+int DecodeTypedColumns()
+{
+  // decode integer, number and date columns of all csv files once into binary values with validity bitmap
+  // (the first MAP definition of a column defines the type, other definitions use the string functions)
+  int i, nMapIndex, nColumnIndex, nValidValues = 0, nTypedColumns = 0;
+  pchar *ppCsvDataField;
+  CPFieldMapping pFieldMapping = aFieldMapping;
+  LinkedCsvFile *pCsvFile;
+  TypedColumn *pTypedColumn;
+  TypedValue *pTypedValue;
+  int nErrorCode;
 
-      if (pFieldMapping->nCsvFileIndex == nCsvFileIndex) {
-        // mandatory column missing in header line ?
-        if (bCheck && pFieldMapping->nCsvIndex < 0 && pFieldMapping->csv.bMandatory) {
-          sprintf(szErrorMessage, "Cannot find mandatory column in input file header");
-          LogCsvError(pFieldMapping->nCsvFileIndex, 0, pFieldMapping->nCsvIndex, pFieldMapping->csv.szContent, szEmptyString, szErrorMessage);
-        }
+  for (nMapIndex = 0; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++) {
+    if (pFieldMapping->csv.cOperation != 'M'/*MAP*/ || pFieldMapping->nCsvIndex < 0 || !strchr("IND", pFieldMapping->csv.cType) || pFieldMapping->xml.cType != pFieldMapping->csv.cType)
+      continue;
+    if (pFieldMapping->csv.Transform.nSteps > 0 || pFieldMapping->xml.Transform.nSteps > 0)
+      continue;
+    if (pFieldMapping->nCsvFileIndex < 0 || pFieldMapping->nCsvFileIndex >= nLinkedCsvFiles)
+      continue;
+
+    pCsvFile = aLinkedCsvFile + pFieldMapping->nCsvFileIndex;
+    nColumnIndex = pFieldMapping->nCsvIndex;
+    if (!pCsvFile->aDataFields || nColumnIndex >= pCsvFile->nColumns)
+      continue;
+
+    if (!pCsvFile->aTypedColumn) {
+      pCsvFile->aTypedColumn = (TypedColumn *)calloc(pCsvFile->nColumns, sizeof(TypedColumn));
+      if (!pCsvFile->aTypedColumn) {
+        printf("Error allocating memory for decoded columns of csv file '%s'\n", pCsvFile->szFileName);
+        return -1;
       }
-
-      // start of new IF block ?
-      if (!szIgnoreXPath && pFieldMapping->csv.cOperation == 'I')
-        szIgnoreXPath = pFieldMapping->xml.szContent;
     }
-  }
 
-  // count number of lines
-  pCsvFile->nDataLines = 1;
-  char *pc = pReadPos;
-  while (*pc)
-    if (*pc++ == '\n')
-      pCsvFile->nDataLines++;
+    pTypedColumn = pCsvFile->aTypedColumn + nColumnIndex;
+    if (pTypedColumn->cType)
+      continue;  // column already decoded
 
-  // allocate memory for field pointer array
-  pCsvFile->nDataFieldsBufferSize = pCsvFile->nDataLines * pCsvFile->nColumns * sizeof(pchar);
-  pCsvFile->aDataFields = (pchar*)malloc(pCsvFile->nDataFieldsBufferSize);
+    pTypedColumn->aValue = (TypedValue *)malloc((pCsvFile->nRealDataLines + 1) * sizeof(TypedValue));
+    pTypedColumn->abValid = (unsigned char *)calloc(pCsvFile->nRealDataLines / 8 + 1, 1);
+    if (!pTypedColumn->aValue || !pTypedColumn->abValid) {
+      printf("Error allocating memory for decoded columns of csv file '%s'\n", pCsvFile->szFileName);
+      return -1;
+    }
+    pTypedColumn->cType = pFieldMapping->csv.cType;
+    pTypedColumn->szFormat = pFieldMapping->csv.szFormat;
+    pTypedColumn->pDateCodec = &pFieldMapping->csv.DateFormat;
+
+    ppCsvDataField = pCsvFile->aDataFields + nColumnIndex;
+    pTypedValue = pTypedColumn->aValue;
+
+    for (i = 0; i < pCsvFile->nRealDataLines; i++, pTypedValue++) {
+      if (pTypedColumn->cType == 'I'/*INTEGER*/)
+        nErrorCode = DecodeTypedInteger(*ppCsvDataField ? *ppCsvDataField : "", pTypedValue);
+      else if (pTypedColumn->cType == 'N'/*NUMBER*/)
+        nErrorCode = DecodeTypedNumber(*ppCsvDataField ? *ppCsvDataField : "", cDecimalPoint, pTypedValue);
+      else
+        nErrorCode = DecodeTypedDate(*ppCsvDataField ? *ppCsvDataField : "", pTypedColumn->pDateCodec, pTypedValue);
 
-  if (!pCsvFile->aDataFields) {
-    sprintf(szLastError, "Not enough memory for csv content field buffer input file '%s' (%d bytes for %d lines and %d columns)", pCsvFile->szFileName, pCsvFile->nDataFieldsBufferSize, pCsvFile->nDataLines, pCsvFile->nColumns);
-    puts(szLastError);
-    return -1;  // not enough free memory
-  }
+      if (nErrorCode == TYPED_VALID) {
+        pTypedColumn->abValid[i >> 3] |= (unsigned char)(1 << (i & 7));
+        pTypedColumn->nValidValues++;
+      }
 
-  // initialize flags whether csv values has been quoted or not
-  for (i = 0; i < pCsvFile->nColumns; i++)
-    pCsvFile->abColumnQuoted[i] = false;
+      // increment data field pointer to next csv line
+      ppCsvDataField += pCsvFile->nColumns;
+    }
 
-  // clear field pointer array
-  memset(pCsvFile->aDataFields, 0, pCsvFile->nDataFieldsBufferSize);
+    // check limits of this field mapping for the whole column
+    if (CheckTypedColumnLimits(pTypedColumn, &pFieldMapping->csv, pCsvFile->nRealDataLines) != 0) {
+      printf("Error allocating memory for decoded columns of csv file '%s'\n", pCsvFile->szFileName);
+      return -1;
+    }
 
-  pchar *pCsvDataFields = pCsvFile->aDataFields;
+    nTypedColumns++;
+    nValidValues += pTypedColumn->nValidValues;
+  }
 
-  while (pLine = GetNextLine(&pReadPos)) {
-    //if (nRealCsvDataLines >= 761)
-    //  i = 0;  // for debugging purposes only!
+  if (bTrace)
+    printf("Decoded columns: %d (%d valid values)\n", nTypedColumns, nValidValues);
 
-    if (pCsvFile->nRealDataLines == 0 && !*szCsvHeader2)
-      mystrncpy(szTempHeader, pLine, MAX_HEADER_SIZE);
+  return 0;
+}
 
-    // parse current csv line
-    nColumns = GetFields(pLine, cColumnDelimiter, aField, pCsvFile->nColumns, (pCsvFile->nRealDataLines == 0) ? pCsvFile->abColumnQuoted : NULL);
+//--------------------------------------------------------------------------------------------------------
 
-    // count non-empty columns
-    nNonEmptyColumns = 0;
-    for (i = 0; i < nColumns; i++)
-      if (*aField[i])
-        nNonEmptyColumns++;
+int ConvertCsvColumns()
+{
+  // convert mapped csv columns into xml values before generating the xml document (option -batch)
+  // all columns are converted for a block of csv lines before the next block; empty and invalid values are
+  // converted again when used, so defaults are applied and errors are logged in the usual order
+  // (values decoded with option -typed are formatted from the decoded value like in MapCsvToXmlValue)
+  int nMapIndex, nLine, nFirstLine, nLastLine, nLines, nMaxLines = 0, nColumns = 0, nValues = 0;
+  FieldMapping *pFieldMapping;
+  ConvertedColumn *pColumn;
+  cpchar pCsvValue;
+  pchar pXmlValue, pNewValues;
+
+  // allocate offsets and values of mapped columns
+  for (nMapIndex = 0, pFieldMapping = aFieldMapping; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++) {
+    if (pFieldMapping->csv.cOperation != 'M'/*MAP*/ || pFieldMapping->xml.cOperation != 'M'/*MAP*/ || pFieldMapping->nCsvIndex < 0 || !pFieldMapping->pConvertCsvToXml)
+      continue;
+    if (pFieldMapping->nCsvFileIndex < 0 || pFieldMapping->nCsvFileIndex >= nLinkedCsvFiles)
+      continue;
+
+    pColumn = &pFieldMapping->Converted;
+    nLines = aLinkedCsvFile[pFieldMapping->nCsvFileIndex].nRealDataLines;
+    pColumn->nSize = nLines * 16 + MAX_VALUE_SIZE;
+    pColumn->nUsed = 0;
+    pColumn->anOffset = (int*)malloc((nLines + 1) * sizeof(int));
+    pColumn->pValues = (pchar)malloc(pColumn->nSize);
+    if (!pColumn->anOffset || !pColumn->pValues) {
+      strcpy(szLastError, "Not enough memory for converted csv columns");
+      puts(szLastError);
+      return -1;
+    }
 
-    if (nNonEmptyColumns >= 3 && pCsvFile->nRealDataLines == 0 && !*szCsvHeader2) {
-      // check existance of second header line
-      nFound = 0;
+    if (nLines > nMaxLines)
+      nMaxLines = nLines;
+    nColumns++;
+  }
 
-      for (nMapIndex = 0, pFieldMapping = aFieldMapping; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++) {
-        bFound = false;
-
-        if (strchr("CIMU"/*CHANGE,IF,MAP,UNIQUE*/, pFieldMapping->csv.cOperation)) {
-          // search for column name in potential csv header
-          for (nColumnIndex = 0; nColumnIndex < nColumns && !bFound; nColumnIndex++)
-            if (MatchingColumnName(aField[nColumnIndex], pFieldMapping->csv.szContent) || MatchingColumnName(aField[nColumnIndex], pFieldMapping->csv.szContent2)) {
-              bFound = true;
-              nFound++;
-            }
+  for (nFirstLine = 0; nFirstLine < nMaxLines; nFirstLine += CONVERSION_BLOCK_LINES) {
+    for (nMapIndex = 0, pFieldMapping = aFieldMapping; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++) {
+      pColumn = &pFieldMapping->Converted;
+      if (!pColumn->anOffset)
+        continue;
+
+      nLastLine = nFirstLine + CONVERSION_BLOCK_LINES;
+      if (nLastLine > aLinkedCsvFile[pFieldMapping->nCsvFileIndex].nRealDataLines)
+        nLastLine = aLinkedCsvFile[pFieldMapping->nCsvFileIndex].nRealDataLines;
+
+      for (nLine = nFirstLine; nLine < nLastLine; nLine++) {
+        pColumn->anOffset[nLine] = -1;
+        pCsvValue = GetCsvFieldValue(pFieldMapping->nCsvFileIndex, nLine, pFieldMapping->nCsvIndex);
+        if (!pCsvValue || !*pCsvValue)
+          continue;
+
+        // enough space for the longest xml value ?
+        if (pColumn->nSize - pColumn->nUsed < MAX_VALUE_SIZE) {
+          pNewValues = (pchar)realloc(pColumn->pValues, 2 * pColumn->nSize);
+          if (!pNewValues) {
+            strcpy(szLastError, "Not enough memory for converted csv columns");
+            puts(szLastError);
+            return -1;
+          }
+          pColumn->pValues = pNewValues;
+          pColumn->nSize *= 2;
         }
-      }
 
-      if (nFound >= pCsvFile->nColumns / 2) {
-        // save second header line, if minimum half of the columns is matching column names
-        mystrncpy(szCsvHeader2, szTempHeader, MAX_HEADER_SIZE);
-        nNonEmptyColumns = 0;
+        pXmlValue = pColumn->pValues + pColumn->nUsed;
+        *pXmlValue = '\0';
+        if (ConvertCsvCell(pFieldMapping, pCsvValue, nLine, pXmlValue, MAX_VALUE_SIZE) == 0) {
+          pColumn->anOffset[nLine] = pColumn->nUsed;
+          pColumn->nUsed += strlen(pXmlValue) + 1;
+          nValues++;
+        }
       }
     }
-
-    if (nNonEmptyColumns >= 3 && pCsvFile->nRealDataLines < pCsvFile->nDataLines) {
-      // copy pointer of fields content to field pointer array
-      memcpy(pCsvDataFields, aField, nColumns * sizeof(pchar));
-      // initialize non existing fields at the end of the line with empty strings
-      for (i = nColumns; i < pCsvFile->nColumns; i++)
-        pCsvDataFields[i] = (pchar)szEmptyString;
-      // next line
-      pCsvDataFields += pCsvFile->nColumns;
-      pCsvFile->nRealDataLines++;
-    }
   }
 
-  return nFieldMappings;
+  if (bTrace)
+    printf("Converted columns: %d (%d values)\n", nColumns, nValues);
+
+  return 0;
 }
-// end of function "ReadCsvData"
+// end of function "ConvertCsvColumns"
 
 //--------------------------------------------------------------------------------------------------------
 
-cpchar GetCsvFieldValue(int nCsvFileIndex, int nCsvDataLine, int nCsvColumn)
+cpchar GetConvertedCsvValue(CPFieldMapping pFieldMapping, int nCsvDataLine)
 {
-  cpchar pResult = NULL;
-  LinkedCsvFile *pLinkedCsvFile;
+  // xml value converted by ConvertCsvColumns (NULL = convert value now)
+  ConvertedColumn const *pColumn = &pFieldMapping->Converted;
 
-  if (nCsvFileIndex >= 0 && nCsvFileIndex < nLinkedCsvFiles) {
-    pLinkedCsvFile = aLinkedCsvFile + nCsvFileIndex;
-    if (nCsvDataLine >= 0 && nCsvDataLine < pLinkedCsvFile->nRealDataLines && nCsvColumn >= 0 && nCsvColumn < pLinkedCsvFile->nColumns)
-      pResult = pLinkedCsvFile->aDataFields[nCsvDataLine * pLinkedCsvFile->nColumns + nCsvColumn];
-  }
+  if (!pColumn->anOffset || nCsvDataLine < 0 || nCsvDataLine >= aLinkedCsvFile[pFieldMapping->nCsvFileIndex].nRealDataLines || pColumn->anOffset[nCsvDataLine] < 0)
+    return NULL;
 
-  return pResult;
+  return pColumn->pValues + pColumn->anOffset[nCsvDataLine];
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-cpchar GetLinkedCsvFieldValue(int nCsvFileIndex, int nCsvDataLine, int nCsvColumn)
+int GetColumnIndex(cpchar szColumnName, int nCsvFileIndex)
 {
-  // get csv field value within current table window (starting at nMatchingFirstLine and ending at nMatchingLastLine)
-  cpchar pResult = NULL;
-  LinkedCsvFile *pLinkedCsvFile;
+  int nMapIndex;
+  CPFieldMapping pFieldMapping;
 
-  if (nCsvFileIndex >= 0 && nCsvFileIndex < nLinkedCsvFiles) {
-    pLinkedCsvFile = aLinkedCsvFile + nCsvFileIndex;
-    if (pLinkedCsvFile->nMatchingFirstLine >= 0 && pLinkedCsvFile->nMatchingLastLine >= 0) {
-      int nRealCsvDataLine = nCsvDataLine + pLinkedCsvFile->nMatchingFirstLine;
-      if (nRealCsvDataLine >= pLinkedCsvFile->nMatchingFirstLine && nRealCsvDataLine <= pLinkedCsvFile->nMatchingLastLine && nCsvColumn >= 0 && nCsvColumn < pLinkedCsvFile->nColumns)
-        pResult = pLinkedCsvFile->aDataFields[nRealCsvDataLine * pLinkedCsvFile->nColumns + nCsvColumn];
-    }
-  }
+  // loop over all mapping fields
+  for (nMapIndex = 0, pFieldMapping = aFieldMapping; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++)
+    if (pFieldMapping->csv.cOperation == 'M' && (stricmp(szColumnName, pFieldMapping->csv.szContent) == 0 || stricmp(szColumnName, pFieldMapping->csv.szContent2) == 0))
+      return pFieldMapping->nCsvIndex;
 
-  return pResult;
+  // column not mapped => search in header line of csv file
+  if (nCsvFileIndex >= 0 && nCsvFileIndex < nLinkedCsvFiles)
+    return FindNameIndexFirst(&aLinkedCsvFile[nCsvFileIndex].HeaderIndex, szColumnName);
+
+  return -1;
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-bool IsNewCsvFieldValue(int nCsvFileIndex, int nCsvDataLines, int nCsvColumn, cpchar szCsvValue)
+void ResolveCsvConditionColumns(CPCondition pCondition, int nCsvFileIndex, bool bMappedColumns)
 {
-  bool bResult = false;
-  LinkedCsvFile *pLinkedCsvFile;
+  // get column indices of column names (names of mapped columns or column names of the csv header line)
+  PSimpleCondition pSimpleCondition = pCondition->pSimpleCondition;
+  const NameIndex *pHeaderIndex = &aLinkedCsvFile[nCsvFileIndex].HeaderIndex;
 
-  if (nCsvFileIndex >= 0 && nCsvFileIndex < nLinkedCsvFiles) {
-    pLinkedCsvFile = aLinkedCsvFile + nCsvFileIndex;
-    if (nCsvDataLines >= 0 && nCsvDataLines < pLinkedCsvFile->nRealDataLines && nCsvColumn >= 0 && nCsvColumn < pLinkedCsvFile->nColumns) {
-      bResult = true;
-      cpchar *ppCsvValue = (cpchar*)(pLinkedCsvFile->aDataFields + nCsvColumn);
-      for (int i = 0; i < nCsvDataLines; i++) {
-        if (strcmp(szCsvValue, *ppCsvValue) == 0)
-          return false;
-        ppCsvValue += pLinkedCsvFile->nColumns;
-      }
-    }
+  if (pCondition->pComplexCondition) {
+    ResolveCsvConditionColumns(&pCondition->pComplexCondition->LeftCondition, nCsvFileIndex, bMappedColumns);
+    ResolveCsvConditionColumns(&pCondition->pComplexCondition->RightCondition, nCsvFileIndex, bMappedColumns);
   }
 
-  return bResult;
+  if (pSimpleCondition) {
+    pSimpleCondition->nLeftColumnIndex = bMappedColumns ? GetColumnIndex(pSimpleCondition->szLeftPart, nCsvFileIndex) : FindNameIndexFirst(pHeaderIndex, pSimpleCondition->szLeftPart);
+    if (*pSimpleCondition->szRightPart != '\'')
+      pSimpleCondition->nRightColumnIndex = bMappedColumns ? GetColumnIndex(pSimpleCondition->szRightPart, nCsvFileIndex) : FindNameIndexFirst(pHeaderIndex, pSimpleCondition->szRightPart);
+  }
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-int GetNumberOfDigits(cpchar szValue)
+void ResolveCsvConditions()
 {
-  int nResult = 0;
-
-  for (cpchar pPos = szValue; *pPos >= '0' && *pPos <= '9'; pPos++)
-    nResult++;
+  // get column indices of all column names used in csv conditions
+  FieldMapping *pFieldMapping = aFieldMapping;
 
-  return nResult;
+  for (int nMapIndex = 0; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++)
+    if (pFieldMapping->nCsvFileIndex >= 0 && pFieldMapping->nCsvFileIndex < nLinkedCsvFiles)
+      ResolveCsvConditionColumns(&pFieldMapping->csv.Condition, pFieldMapping->nCsvFileIndex, true);
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-int GetCsvDecimalPoint()
+bool EvaluateCsvRowCondition(cpchar const *aRowField, int nRowFields, CPCondition pCondition)
 {
-  int i, nColumnIndex, nMapIndex, nDigitsBehindComma, nDigitsBehindPoint;
-  int nCommaUsage = 0;
-  int nPointUsage = 0;
-  int nReturnCode = 0;
-  pchar *ppCsvDataField;
-  cpchar pCsvFieldValue = NULL;
-  cpchar pCommaPos = NULL;
-  cpchar pPointPos = NULL;
-  CPFieldMapping pFieldMapping = aFieldMapping;
-  LinkedCsvFile *pCsvFile = aLinkedCsvFile;
-
-  for (nMapIndex = 0; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++) {
-    if (pFieldMapping->csv.cType == 'N'/*NUMBER*/ && pFieldMapping->csv.cOperation == 'M'/*MAP*/ && pFieldMapping->nCsvIndex >= 0)
-    {
-      nColumnIndex = pFieldMapping->nCsvIndex;
-      ppCsvDataField = pCsvFile->aDataFields + nColumnIndex;
-
-      for (i = 0; i < pCsvFile->nRealDataLines; i++) {
-        pCsvFieldValue = *ppCsvDataField;
-        //pCsvFieldValue = GetCsvFieldValue(i, nColumnIndex);
+  // evaluate csv condition for the fields of a csv line
+  bool bResult = false, bResult2;
+  cpchar pszLeftValue, pszRightValue;
+  int nColumnIndex;
+  PSimpleCondition pSimpleCondition = pCondition->pSimpleCondition;
 
-        pCommaPos = strchr(pCsvFieldValue, ',');
-        if (pCommaPos)
-          nDigitsBehindComma = GetNumberOfDigits(pCommaPos+1);
-        else
-          nDigitsBehindComma = -1;
+  if (pCondition->pComplexCondition) {
+    bResult = EvaluateCsvRowCondition(aRowField, nRowFields, &pCondition->pComplexCondition->LeftCondition);
+    bResult2 = EvaluateCsvRowCondition(aRowField, nRowFields, &pCondition->pComplexCondition->RightCondition);
+    if (pCondition->pComplexCondition->op == AND_OP)
+      bResult = bResult && bResult2;
+    if (pCondition->pComplexCondition->op == OR_OP)
+      bResult = bResult || bResult2;
+  }
 
-        pPointPos = strchr(pCsvFieldValue, '.');
-        if (pPointPos)
-          nDigitsBehindPoint = GetNumberOfDigits(pPointPos+1);
-        else
-          nDigitsBehindPoint = -1;
+  if (pSimpleCondition) {
+    // condition likes "CCY != FUND_CCY" or "48_* = '1'" (missing fields at the end of the line are empty)
+    nColumnIndex = pSimpleCondition->nLeftColumnIndex;
+    pszLeftValue = (nColumnIndex < 0) ? NULL : (nColumnIndex < nRowFields) ? aRowField[nColumnIndex] : szEmptyString;
 
-        if (pCommaPos) {
-          if (pPointPos) {
-            if (pCommaPos > pPointPos)
-              nCommaUsage++;  // comma is behind point
-            else
-              nPointUsage++;  // point is behind comma
-          }
-          else
-            if (nDigitsBehindComma != 3)
-              nCommaUsage++;  // high probability of comma used as decimal point
-        }
-        else {
-          if (pPointPos && nDigitsBehindPoint != 3)
-            nPointUsage++;  // high probability of point used as decimal point
-        }
+    if (*pSimpleCondition->szRightPart == '\'')
+      pszRightValue = pSimpleCondition->szCurrentValue ? pSimpleCondition->szCurrentValue : szEmptyString;
+    else {
+      nColumnIndex = pSimpleCondition->nRightColumnIndex;
+      pszRightValue = (nColumnIndex < 0) ? NULL : (nColumnIndex < nRowFields) ? aRowField[nColumnIndex] : szEmptyString;
+    }
 
-        // increment data field pointer to next csv line
-        ppCsvDataField += pCsvFile->nColumns;
-      }
+    if (pszLeftValue && pszRightValue) {
+      if (*pSimpleCondition->szOperator == '=')
+        bResult = (strcmp(pszLeftValue, pszRightValue) == 0);
+      if (*pSimpleCondition->szOperator == '!')
+        bResult = (strcmp(pszLeftValue, pszRightValue) != 0);
+      if (*pSimpleCondition->szOperator == '<')
+        bResult = (strcmp(pszLeftValue, pszRightValue) < 0);
+      if (*pSimpleCondition->szOperator == '>')
+        bResult = (strcmp(pszLeftValue, pszRightValue) > 0);
     }
   }
 
-  cDecimalPoint = (nCommaUsage > nPointUsage) ? ',' : '.';
-  return nReturnCode;
+  return bResult;
 }
 
 //--------------------------------------------------------------------------------------------------------
 
-int GetColumnIndex(cpchar szColumnName)
+bool EvaluateCsvCondition(int nCsvFileIndex, int nCsvDataLine, CPCondition pCondition)
 {
-  int nMapIndex;
-  CPFieldMapping pFieldMapping;
+  // evaluate csv condition for a stored csv data line
+  LinkedCsvFile *pLinkedCsvFile;
 
-  // loop over all mapping fields
-  for (nMapIndex = 0, pFieldMapping = aFieldMapping; nMapIndex < nFieldMappings; nMapIndex++, pFieldMapping++)
-    if (pFieldMapping->csv.cOperation == 'M' && (stricmp(szColumnName, pFieldMapping->csv.szContent) == 0 || stricmp(szColumnName, pFieldMapping->csv.szContent2) == 0))
-      return pFieldMapping->nCsvIndex;
+  if (nCsvFileIndex < 0 || nCsvFileIndex >= nLinkedCsvFiles)
+    return false;
 
-  return -1;
+  pLinkedCsvFile = aLinkedCsvFile + nCsvFileIndex;
+  if (nCsvDataLine < 0 || nCsvDataLine >= pLinkedCsvFile->nRealDataLines)
+    return false;
+
+  return EvaluateCsvRowCondition((cpchar const*)pLinkedCsvFile->aDataFields + nCsvDataLine * pLinkedCsvFile->nColumns, pLinkedCsvFile->nColumns, pCondition);
 }
 
 //--------------------------------------------------------------------------------------------------------
 
 bool CheckCsvCondition(int nCsvDataLine, CPFieldMapping pFieldMapping)
 {
-  char szCondition[MAX_CONDITION_SIZE];
-  pchar pszLeftPart, pszOperator, pszRightPart;
-  cpchar pszFieldValue, pszLeftValue, pszRightValue;
-  int len, nLeftColumnIndex, nRightColumnIndex;
+  cpchar pszFieldValue;
   bool bMatch = false;
 
   if (stricmp(pFieldMapping->csv.szCondition, "contentisvalid()") == 0) {
@@ -3311,38 +7056,8 @@ bool CheckCsvCondition(int nCsvDataLine, CPFieldMapping pFieldMapping)
     return bMatch;
   }
 
-  // condition likes "CCY != FUND_CCY" or "48_* = '1'" ?
-  OldParseCondition(pFieldMapping->csv.szCondition, szCondition, &pszLeftPart, &pszOperator, &pszRightPart);
-
-  if (pszLeftPart && pszOperator && pszRightPart) {
-    // condition found
-    nLeftColumnIndex = GetColumnIndex(pszLeftPart);
-    pszLeftValue = GetCsvFieldValue(pFieldMapping->nCsvFileIndex, nCsvDataLine, nLeftColumnIndex);
-
-    if (*pszRightPart == '\'') {
-      pszRightValue = pszRightPart + 1;
-      len = strlen(pszRightPart);
-      if (len > 0 && pszRightPart[len-1] == '\'')
-        pszRightPart[len-1] = '\0';
-    }
-    else {
-      nRightColumnIndex = GetColumnIndex(pszRightPart);
-      pszRightValue = GetCsvFieldValue(pFieldMapping->nCsvFileIndex, nCsvDataLine, nRightColumnIndex);
-    }
-
-    if (pszLeftValue && pszRightValue) {
-      if (*pszOperator == '=')
-        bMatch = (strcmp(pszLeftValue, pszRightValue) == 0);
-      if (*pszOperator == '!')
-        bMatch = (strcmp(pszLeftValue, pszRightValue) != 0);
-      if (*pszOperator == '<')
-        bMatch = (strcmp(pszLeftValue, pszRightValue) < 0);
-      if (*pszOperator == '>')
-        bMatch = (strcmp(pszLeftValue, pszRightValue) > 0);
-    }
-  }
-
-  return bMatch;
+  // condition parsed when loading the mapping definition (column indices resolved by ReadCsvData)
+  return EvaluateCsvCondition(pFieldMapping->nCsvFileIndex, nCsvDataLine, &pFieldMapping->csv.Condition);
 }
 
 //--------------------------------------------------------------------------------------------------------
@@ -3701,6 +7416,7 @@ int AddXmlField(xmlDocPtr pDoc, CPFieldMapping pFieldMapping, cpchar XPath, int
 {
   char szValue[MAX_VALUE_SIZE] = "";
   cpchar pCsvFieldValue = NULL;
+  cpchar pXmlValue = szValue;
   int nReturnCode;
 
   if (pFieldMapping->xml.cOperation == 'M'/*MAP*/)
@@ -3716,13 +7432,20 @@ int AddXmlField(xmlDocPtr pDoc, CPFieldMapping pFieldMapping, cpchar XPath, int
         pCsvFieldValue = szEmptyString;
 
       // no csv field value available, but default value defined ?
-      if (!*pCsvFieldValue && *pFieldMapping->csv.szDefault)
+      if (!*pCsvFieldValue && *pFieldMapping->csv.szDefault) {
         pCsvFieldValue = pFieldMapping->csv.szDefault;  // use default value
+        nCsvDataLine = -1;  // decoded csv value not applicable
+      }
 
       if (pCsvFieldValue /* && (*pCsvFieldValue || pFieldMapping->xml.bMandatory)*/) {
-        // check csv value and transform to xml format
-        nReturnCode = MapCsvToXmlValue(pFieldMapping, pCsvFieldValue, szValue, MAX_VALUE_SIZE);
-        SetNodeValue(pDoc, NULL, XPath, szValue, pFieldMapping, pAttributeNameValueList);
+        // value already converted column by column (option -batch) ?
+        pXmlValue = GetConvertedCsvValue(pFieldMapping, nCsvDataLine);
+        if (!pXmlValue) {
+          // check csv value and transform to xml format
+          nReturnCode = MapCsvToXmlValue(pFieldMapping, pCsvFieldValue, szValue, MAX_VALUE_SIZE, nCsvDataLine);
+          pXmlValue = szValue;
+        }
+        SetNodeValue(pDoc, NULL, XPath, pXmlValue, pFieldMapping, pAttributeNameValueList);
       }
     }
 
@@ -3732,7 +7455,7 @@ int AddXmlField(xmlDocPtr pDoc, CPFieldMapping pFieldMapping, cpchar XPath, int
     }
 
     if (strcmp(XPath, "ControlData/UniqueDocumentID") == 0)
-      mystrncpy(szUniqueDocumentID, szValue, MAX_UNIQUE_DOCUMENT_ID_SIZE);
+      mystrncpy(szUniqueDocumentID, pXmlValue, MAX_UNIQUE_DOCUMENT_ID_SIZE);
   }
 
   return 0;
@@ -3781,6 +7504,7 @@ void GetMatchingLines(LinkedCsvFile *pLinkedCsvFile)
 {
   int nDataLine = 0;
   pchar *pDataField = pLinkedCsvFile->aDataFields + pLinkedCsvFile->nLinkedColumnIndex;
+  bool bInterned = IsInternedCsvColumn(0, pLinkedCsvFile->nLinkedMainColumnIndex) && IsInternedCsvColumn((int)(pLinkedCsvFile - aLinkedCsvFile), pLinkedCsvFile->nLinkedColumnIndex);
 
   pLinkedCsvFile->nMatchingFirstLine = -1;
   pLinkedCsvFile->nMatchingLastLine = -1;
@@ -3788,7 +7512,7 @@ void GetMatchingLines(LinkedCsvFile *pLinkedCsvFile)
   if (pLinkedCsvFile->pszCurrentKeyValue != NULL)
   {
     while (nDataLine < pLinkedCsvFile->nRealDataLines) {
-      if (strcmp(pLinkedCsvFile->pszCurrentKeyValue, *pDataField) == 0) {
+      if (bInterned ? (pLinkedCsvFile->pszCurrentKeyValue == *pDataField) : (strcmp(pLinkedCsvFile->pszCurrentKeyValue, *pDataField) == 0)) {
         pLinkedCsvFile->nMatchingFirstLine = nDataLine;
         break;
       }
@@ -3800,7 +7524,7 @@ void GetMatchingLines(LinkedCsvFile *pLinkedCsvFile)
       pDataField += pLinkedCsvFile->nColumns;
       nDataLine++;
       while (nDataLine < pLinkedCsvFile->nRealDataLines) {
-        if (strcmp(pLinkedCsvFile->pszCurrentKeyValue, *pDataField) != 0)
+        if (bInterned ? (pLinkedCsvFile->pszCurrentKeyValue != *pDataField) : (strcmp(pLinkedCsvFile->pszCurrentKeyValue, *pDataField) != 0))
           break;
         pDataField += pLinkedCsvFile->nColumns;
         nDataLine++;
@@ -3831,7 +7555,7 @@ int GenerateXmlDocument()
   bool abFirstLoopRecord[MAX_LOOPS];
   AttributeNameValue *pAttrNameValue;
   AttributeNameValueList AttrNameValueList;
-  int i, j, nVirtualDataLine, nMapIndex, nLoopIndex, nActiveCsvFileIndex, nNextCsvFileIndex;
+  int i, nVirtualDataLine, nMapIndex, nLoopIndex, nActiveCsvFileIndex, nNextCsvFileIndex;
   int nFirstLoopMapIndex = -1;
   int nResult = 0;
   bool bAddFieldValue, bMap, bMatch, bNewValue;
@@ -3845,6 +7569,11 @@ int GenerateXmlDocument()
 
 	// Creates a new document, a node and set it as a root node
   pXmlDoc = xmlNewDoc(BAD_CAST "1.0");
+  if (pConstantXmlValues) {
+    // node names and constant values are taken from the dictionary of the document
+    pXmlDoc->dict = pConstantXmlValues;
+    xmlDictReference(pConstantXmlValues);
+  }
   pRootNode = xmlNewNode(NULL, BAD_CAST szRootNodeName);
 	xmlDocSetRootElement(pXmlDoc, pRootNode);
   nLoops = 0;
@@ -3894,14 +7623,6 @@ int GenerateXmlDocument()
   {
     //nCurrentCsvLine = nDataLine + 1;  // for csv error logging
 
-    // initialize column error flags
-    pLinkedCsvFile = aLinkedCsvFile;
-    for (i = 0; i < nLinkedCsvFiles; i++) {
-      for (j = pLinkedCsvFile->nColumns - 1; j >= 0; j--)
-        pLinkedCsvFile->abColumnError[j] = false;
-      pLinkedCsvFile++;
-    }
-
     // update matching window of linked csv files (if necessary)
     pLinkedCsvFile = aLinkedCsvFile;
     for (i = 1; i < nLinkedCsvFiles; i++) {
@@ -3946,6 +7667,8 @@ int GenerateXmlDocument()
           pCsvFieldValue = GetLinkedCsvFieldValue(pLoopFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pLoopFieldMapping->nCsvIndex);
           if (pLoopFieldMapping->csv.cOperation == 'U' /*UNIQUE*/)
             bNewValue = IsNewCsvFieldValue(pLoopFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pLoopFieldMapping->nCsvIndex, pCsvFieldValue);
+          else if (IsInternedCsvColumn(pLoopFieldMapping->nCsvFileIndex, pLoopFieldMapping->nCsvIndex))
+            bNewValue = (pCsvFieldValue != apLastValues[nLoopIndex]);  // equal values have the same pointer
           else  // cOperation == 'C' /*CHANGE*/
             bNewValue = (strcmp(pCsvFieldValue, apLastValues[nLoopIndex]) != 0);
 
@@ -4012,7 +7735,7 @@ int GenerateXmlDocument()
             pCsvFieldValue = GetCsvFieldValue(pFieldMapping->nCsvFileIndex, pLinkedCsvFile->nCurrentCsvLine, pFieldMapping->nCsvIndex);
             if (pCsvFieldValue) {
               if (strchr(",.[", pFieldMapping->csv.szFormat[0]) != NULL)  // originally '('
-                bMatch = CheckRegex(pCsvFieldValue, pFieldMapping->csv.szFormat);  // e.g. AssetType matching "(EQ)" [containing "EQ"] ?
+                bMatch = CheckFieldFormat(pCsvFieldValue, &pFieldMapping->csv);  // e.g. AssetType matching "(EQ)" [containing "EQ"] ?
               else
                 bMatch = (*pCsvFieldValue != '\0');  // field non-empty ?
             }
@@ -4166,6 +7889,7 @@ int ConvertCsvToXml(cpchar szXmlFileName)
   LinkedCsvFile *pLinkedCsvFile;
 
   nErrors = 0;
+  FreeErrorCollector(&CellErrors);
   *szLastError = '\0';
   ResetFieldIndices();
 
@@ -4173,15 +7897,80 @@ int ConvertCsvToXml(cpchar szXmlFileName)
   pLinkedCsvFile = aLinkedCsvFile;
   for (i = 0; i < nLinkedCsvFiles; i++) {
     nReturnCode = ReadCsvData(i);
+    if (nReturnCode == -3) {
+      // input file with invalid encoding
+      WriteErrorFile();
+      FreeCsvFileBuffers();
+      return nReturnCode;
+    }
     printf("CSV file %d (%s) :  %d columns, %d real data lines\n", i+1, pLinkedCsvFile->szFileName, pLinkedCsvFile->nColumns, pLinkedCsvFile->nRealDataLines);
+    if (pLinkedCsvFile->nFilteredDataLines > 0)
+      printf("CSV file %d (%s) :  %d data lines skipped by filter\n", i+1, pLinkedCsvFile->szFileName, pLinkedCsvFile->nFilteredDataLines);
     pLinkedCsvFile++;
   }
 
-  printf("XML output file: %s\n", szXmlFileName);
+  if (bValidateOnly)
+    printf("Validation only (no XML output file)\n");
+  else
+    printf("XML output file: %s\n", szXmlFileName);
   printf("Error file: %s\n\n", szErrorFileName);
 
   nReturnCode = GetCsvDecimalPoint();
 
+  // replace repeating values of loop and key columns by dictionary values
+  if (nReturnCode == 0) {
+    nReturnCode = InternCsvColumns();
+    if (nReturnCode != 0) {
+      WriteErrorFile();
+      FreeCsvFileBuffers();
+      return nReturnCode;
+    }
+  }
+
+  // decode integer, number and date columns once (optional)
+  if (bTypedDecode && nReturnCode == 0) {
+    nReturnCode = DecodeTypedColumns();
+    if (nReturnCode != 0) {
+      WriteErrorFile();
+      FreeCsvFileBuffers();
+      return nReturnCode;
+    }
+  }
+
+  if (bValidateOnly) {
+    // check csv values and write error file only
+    if (nReturnCode == 0)
+      nReturnCode = ValidateCsvDocument();
+
+    // write collected errors to error file (if any)
+    WriteErrorFile();
+
+    printf("Number of errors detected: %d\n\n", nErrors);
+
+    FreeCsvFileBuffers();
+    return nReturnCode;
+  }
+
+  // check all mapped csv values in parallel before generating the xml document (optional)
+  if (nValidationThreads > 0 && nReturnCode == 0) {
+    nReturnCode = ValidateCsvColumns(nValidationThreads);
+    if (nReturnCode != 0) {
+      WriteErrorFile();
+      FreeCsvFileBuffers();
+      return nReturnCode;
+    }
+  }
+
+  // convert mapped csv columns in blocks of lines (optional, values are already converted by the validation threads)
+  if (bBatchConvert && nValidationThreads == 0 && nReturnCode == 0) {
+    nReturnCode = ConvertCsvColumns();
+    if (nReturnCode != 0) {
+      WriteErrorFile();
+      FreeCsvFileBuffers();
+      return nReturnCode;
+    }
+  }
+
   /*
   if (bTrace) {
     pchar *pField = aCsvDataFields;
@@ -4207,11 +7996,8 @@ int ConvertCsvToXml(cpchar szXmlFileName)
   // save counter values (if used)
   nReturnCode = SaveCounterValues();
 
-  // close error file (if open)
-  if (pErrorFile) {
-    fclose(pErrorFile);
-    pErrorFile = NULL;
-  }
+  // write collected errors to error file (if any)
+  WriteErrorFile();
 
   printf("Number of errors detected: %d\n\n", nErrors);
 
@@ -4425,7 +8211,7 @@ int WriteCsvFile(cpchar szFileName)
           pCsvFieldValue = pSourceFieldMapping->xml.szValue;
           if (pCsvFieldValue) {
             if (pFieldMapping->csv.szFormat[0] == ',')  // originally '('
-              bMatch = CheckRegex(pCsvFieldValue, pFieldMapping->csv.szFormat);  // e.g. AssetType matching "(EQ)" (containing "EQ") ?
+              bMatch = CheckFieldFormat(pCsvFieldValue, &pFieldMapping->csv);  // e.g. AssetType matching "(EQ)" (containing "EQ") ?
             else
               bMatch = (*pCsvFieldValue != '\0');  // field non-empty ?
           }
@@ -4586,6 +8372,7 @@ int ConvertXmlToCsv(cpchar szXmlFileName, cpchar szCsvTemplateFileName, cpchar s
   //char szValue[MAX_VALUE_SIZE];
 
   nErrors = 0;
+  FreeErrorCollector(&CellErrors);
   *szLastError = '\0';
   *szUniqueDocumentID = '\0';
 
@@ -4635,11 +8422,8 @@ int ConvertXmlToCsv(cpchar szXmlFileName, cpchar szCsvTemplateFileName, cpchar s
   // save counter values (if used)
   nReturnCode = SaveCounterValues();
 
-  // close error file (if open)
-  if (pErrorFile) {
-    fclose(pErrorFile);
-    pErrorFile = NULL;
-  }
+  // write collected errors to error file (if any)
+  WriteErrorFile();
 
   printf("CSV Data Columns: %d\nCSV Data Lines: %d\n\n", pCsvFile->nColumns, pCsvFile->nRealDataLines);
   printf("Number of errors detected: %d\n\n", nErrors);
@@ -4760,6 +8544,50 @@ int main(int argc, char **argv)
   // convert -conversion csv2xml -input c:\csv-xml-converter\inputfiles\*.csv -mapping mapping.csv -output c:\csv-xml-converter\outputfiles -errors error -log log.csv -processed processed -counter counter
   // convert -c c2x -i input\*.csv -m holdings-mapping.csv -o output\*.xml -e error -l log.csv -p processed -r counter
   //
+  // INPUT ENCODING:
+  //
+  // csv input files are expected in utf-8 (a byte order mark for utf-8 or utf-16 is detected automatically),
+  // files with invalid utf-8 content are read as windows-1252 unless the encoding is set explicitly:
+  // convert -c c2x -i latin1-input.csv -m mapping.csv -o result.xml -e errors.csv -encoding latin1
+  // convert -c c2x -i input.csv -m mapping.csv -o result.xml -e errors.csv -n utf8
+  //
+  // DATA LINE FILTER:
+  //
+  // only data lines matching the filter condition (syntax of CSV_CONDITION) are converted:
+  // convert -c c2x -i holdings.csv -m holdings-mapping.csv -o holdings.xml -e holdings-errors.csv -filter "FUND_ID = 'F1'"
+  // convert -c c2x -i holdings.csv -m holdings-mapping.csv -o holdings.xml -e holdings-errors.csv -f "(ASSET_TYPE = 'EQ') or (ASSET_TYPE = 'BD')"
+  //
+  // empty lines are always skipped, lines with less than 3 non-empty columns by default; optionally lines
+  // with an empty key column or starting with a comment prefix are skipped:
+  // convert -c c2x -i holdings.csv -m holdings-mapping.csv -o holdings.xml -e holdings-errors.csv -mincolumns 5 -keycolumn ISIN -comment #
+  // convert -c c2x -i holdings.csv -m holdings-mapping.csv -o holdings.xml -e holdings-errors.csv -mc 5 -k ISIN -cm #
+  //
+  // csv files can be checked without generating the xml document (only the error file is written, input files
+  // are not moved to the directory for processed files):
+  // convert -c c2x -i holdings.csv -m holdings-mapping.csv -o holdings.xml -e holdings-errors.csv -validate
+  //
+  // mapped csv values can be checked in parallel before generating the xml document (number of threads):
+  // convert -c c2x -i holdings.csv -m holdings-mapping.csv -o holdings.xml -e holdings-errors.csv -threads 4
+  //
+  // the number of errors written to the error file can be limited per csv column (all errors are counted):
+  // convert -c c2x -i holdings.csv -m holdings-mapping.csv -o holdings.xml -e holdings-errors.csv -maxerrors 100
+  //
+  // fixed width input files without header line are read, if the mapping file defines the columns CSV_POSITION
+  // (first character = 1) and CSV_WIDTH for the csv fields (leading and trailing spaces are removed):
+  // convert -c c2x -i holdings.txt -m holdings-fixed-width-mapping.csv -o holdings.xml -e holdings-errors.csv
+  //
+  // integer, number and date columns can be decoded once after reading the csv file (numbers are written
+  // without leading zeros, invalid values are processed as before):
+  // convert -c c2x -i holdings.csv -m holdings-mapping.csv -o holdings.xml -e holdings-errors.csv -typed
+  //
+  // mapped csv columns can be converted in blocks of 1024 lines before generating the xml document (needs
+  // memory for all converted values):
+  // convert -c c2x -i holdings.csv -m holdings-mapping.csv -o holdings.xml -e holdings-errors.csv -batch
+  //
+  // csv numbers with a thousands separator (ignored when reading csv files, written by xml to csv conversions):
+  // convert -c c2x -i holdings.csv -m holdings-mapping.csv -o holdings.xml -e holdings-errors.csv -thousands '
+  // convert -c x2c -i holdings.xml -m holdings-mapping.csv -t holdings-template.csv -o holdings.csv -e holdings-errors.csv -ts '
+  //
   // convert -conversion xml2csv -iinput input\*.xml -mapping holdings-mapping.csv -template holdings-template.csv -ooutput output\*.csv -error error -log log.csv -processed processed -counter counter
   // convert -c x2c -i input\*.xml -m holdings-mapping.csv -t holdings-template.csv -o output\*.csv -e error -l log.csv -p processed -r counter
   //
@@ -4776,6 +8604,24 @@ int main(int argc, char **argv)
       bParameterProcessed = true;
     }
 
+    if (stricmp(pcParameter, "-VALIDATE") == 0) {
+      // check csv values and write error file without generating the xml document
+      bValidateOnly = true;
+      bParameterProcessed = true;
+    }
+
+    if (stricmp(pcParameter, "-TYPED") == 0) {
+      // decode integer, number and date columns once after reading the csv file
+      bTypedDecode = true;
+      bParameterProcessed = true;
+    }
+
+    if (stricmp(pcParameter, "-BATCH") == 0) {
+      // convert mapped csv columns in blocks of lines before generating the xml document
+      bBatchConvert = true;
+      bParameterProcessed = true;
+    }
+
     if ((stricmp(pcParameter, "-WAIT") == 0 || stricmp(pcParameter, "-W") == 0)) {
       // wait at end of processing
       bWaitAtEnd = true;
@@ -4829,6 +8675,61 @@ int main(int argc, char **argv)
         // directory for counter files
         if ((stricmp(pcParameter, "COUNTER") == 0 || stricmp(pcParameter, "R") == 0) && strlen(pcContent) < MAX_PATH_LEN)
           sprintf(szCounterPath, "%s%c", pcContent, cPathSeparator);
+
+        // number of threads for checking the csv values before generating the xml document
+        if (stricmp(pcParameter, "THREADS") == 0 || stricmp(pcParameter, "TH") == 0) {
+          nValidationThreads = atoi(pcContent);
+          if (nValidationThreads < 1)
+            nValidationThreads = 1;
+          if (nValidationThreads > MAX_VALIDATION_THREADS)
+            nValidationThreads = MAX_VALIDATION_THREADS;
+        }
+
+        // maximum number of errors written to the error file per csv column
+        if (stricmp(pcParameter, "MAXERRORS") == 0 || stricmp(pcParameter, "ME") == 0) {
+          nMaxColumnErrors = atoi(pcContent);
+          if (nMaxColumnErrors < 0)
+            nMaxColumnErrors = 0;  // no limit
+        }
+
+        // minimum number of non-empty columns of csv data lines
+        if (stricmp(pcParameter, "MINCOLUMNS") == 0 || stricmp(pcParameter, "MC") == 0) {
+          nMinNonEmptyColumns = atoi(pcContent);
+          if (nMinNonEmptyColumns < 1)
+            nMinNonEmptyColumns = 1;  // empty lines are always skipped
+        }
+
+        // column that must not be empty in csv data lines
+        if (stricmp(pcParameter, "KEYCOLUMN") == 0 || stricmp(pcParameter, "K") == 0)
+          strcpy(szKeyColumnName, pcContent);
+
+        // thousands separator of csv numbers
+        if (stricmp(pcParameter, "THOUSANDS") == 0 || stricmp(pcParameter, "TS") == 0)
+          cThousandsSeparator = *pcContent;
+
+        // prefix of comment lines in csv files
+        if (stricmp(pcParameter, "COMMENT") == 0 || stricmp(pcParameter, "CM") == 0)
+          strcpy(szCommentPrefix, pcContent);
+
+        // condition for data lines to be converted
+        if (stricmp(pcParameter, "FILTER") == 0 || stricmp(pcParameter, "F") == 0)
+          strcpy(szRowFilter, pcContent);
+
+        // encoding of csv input files
+        if (stricmp(pcParameter, "ENCODING") == 0 || stricmp(pcParameter, "N") == 0) {
+          if (stricmp(pcContent, "auto") == 0)
+            inputEncoding = AUTO_ENCODING;
+          else if (stricmp(pcContent, "utf8") == 0 || stricmp(pcContent, "utf-8") == 0)
+            inputEncoding = UTF8_ENCODING;
+          else if (stricmp(pcContent, "latin1") == 0 || stricmp(pcContent, "iso-8859-1") == 0)
+            inputEncoding = LATIN1_ENCODING;
+          else if (stricmp(pcContent, "cp1252") == 0 || stricmp(pcContent, "windows-1252") == 0)
+            inputEncoding = CP1252_ENCODING;
+          else {
+            printf("Invalid encoding '%s' (valid options: 'auto','utf8','latin1','cp1252')\n", pcContent);
+            goto ProcEnd;
+          }
+        }
       }
     }
   }
@@ -4878,7 +8779,8 @@ int main(int argc, char **argv)
   strcpy(szMappingErrorFileName, szMappingFileName);
   ReplaceExtension(szMappingErrorFileName, "err");
 
-  // read mapping file
+  // read mapping file (constant xml values are only interned for csv2xml conversions)
+  convDir = (stricmp(szConversion, "xml2csv") == 0) ? XML2CSV : CSV2XML;
   printf("Mapping definition: %s\n", szMappingFileName);
   nReturnCode = ReadFieldMappings(szMappingFileName);
   printf("Field mappings loaded: %d\n\n", nFieldMappings);
@@ -4888,6 +8790,19 @@ int main(int argc, char **argv)
     goto ProcEnd;
   }
 
+  // parse filter condition for csv data lines (same syntax as CSV_CONDITION)
+  if (*szRowFilter) {
+    if (stricmp(szConversion, "csv2xml") != 0)
+      puts("Parameter 'filter' is only supported for csv2xml conversions and will be ignored");
+    else {
+      printf("Filter for csv data lines: %s\n\n", szRowFilter);
+      if (ParseCsvCondition(szRowFilter, &RowFilter) != 0) {
+        printf("Invalid filter condition: %s\n", szLastError);
+        goto ProcEnd;
+      }
+    }
+  }
+
   // single or multiple file conversions ?
   pStarPos = strchr(szInput, '*');
 
@@ -4930,7 +8845,8 @@ int main(int argc, char **argv)
 
             // convert csv file to xml format
             nReturnCode = ConvertCsvToXml(szOutputFileName);
-						MyMoveFile(szInputFileName, szProcessedFileName);
+            if (!bValidateOnly)
+              MyMoveFile(szInputFileName, szProcessedFileName);
 
             // add log entry to application log
             AddLog(szLogFileName, "FILE", szConversion, szLastError, nErrors, aLinkedCsvFile[0].nRealDataLines, aLinkedCsvFile[0].szFileName, szMappingFileName, "", szOutputFileName, szProcessedFileName, szUniqueDocumentID, szErrorFileName);
@@ -5016,6 +8932,12 @@ int main(int argc, char **argv)
   }
 
 ProcEnd:
+  // free the interned constant xml values (shared by the xml documents of all converted files)
+  if (pConstantXmlValues) {
+    xmlDictFree(pConstantXmlValues);
+    pConstantXmlValues = NULL;
+  }
+
   if (bWaitAtEnd) {
     puts("\nPress <Enter> to continue/close window\n");
     getchar();